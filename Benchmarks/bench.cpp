@@ -0,0 +1,275 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include "../Structures/NumberTheory/NumberTheory.hpp"
+#include "../Structures/QueryStructures/QueryStructures.hpp"
+
+using namespace QueryStructures;
+
+/*
+Results are printed as JSON by default, to keep them for comparison between versions use
+	./bench --benchmark_out=bench_output.json --benchmark_out_format=json
+and --benchmark_filter=<regex> to run a part of the suite.
+*/
+
+
+template <class T>
+std::vector<T> get_random_values(size_t size, unsigned int seed = 42) {
+	std::mt19937 generator(seed);
+	std::vector<T> values(size);
+	std::generate(values.begin(), values.end(), [&generator]() { return (T)(generator() % 1000); });
+	return values;
+}
+
+std::vector<std::pair<size_t, size_t>> get_random_segments(size_t size, size_t count = 1 << 10, unsigned int seed = 7) {
+	std::mt19937 generator(seed);
+	std::vector<std::pair<size_t, size_t>> segments(count);
+	for (auto& segment : segments) {
+		segment = { generator() % size, generator() % size };
+		if (segment.first > segment.second) {
+			std::swap(segment.first, segment.second);
+		}
+	}
+	return segments;
+}
+
+template <class T>
+T sum(const T& a, const T& b) {
+	return a + b;
+}
+
+
+static void BM_EratosthenesSieveBuild(benchmark::State& state) {
+	size_t n = state.range(0);
+	for (auto _ : state) {
+		NumberTheory::EratosthenesSieve sieve(n);
+		sieve.build();
+		benchmark::DoNotOptimize(sieve.is_prime(n - 1));
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_EratosthenesSieveBuild)->RangeMultiplier(10)->Range(1'000'000, 1'000'000'000)->Unit(benchmark::kMillisecond);
+
+
+static void BM_EratosthenesSieveIteration(benchmark::State& state) {
+	size_t n = state.range(0);
+	NumberTheory::EratosthenesSieve sieve(n);
+	sieve.build();
+	for (auto _ : state) {
+		size_t count = 0;
+		sieve.go_through_prime_numbers([&count](const size_t&) { ++count; });
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_EratosthenesSieveIteration)->RangeMultiplier(10)->Range(1'000'000, 1'000'000'000)->Unit(benchmark::kMillisecond);
+
+
+static void BM_SegmentedWheelListPrimes(benchmark::State& state) {
+	size_t n = state.range(0);
+	for (auto _ : state) {
+		NumberTheory::SegmentedWheel wheel(n);
+		size_t count = 0;
+		wheel.ListPrimes([&count](const size_t&) { ++count; });
+		benchmark::DoNotOptimize(count);
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_SegmentedWheelListPrimes)->RangeMultiplier(10)->Range(1'000'000, 10'000'000'000)->Unit(benchmark::kMillisecond);
+
+
+static void BM_FactorizerBuild(benchmark::State& state) {
+	for (auto _ : state) {
+		NumberTheory::Factorizer factorizer;
+		factorizer.build(state.range(0));
+		benchmark::DoNotOptimize(factorizer.get_size());
+	}
+}
+BENCHMARK(BM_FactorizerBuild)->RangeMultiplier(10)->Range(1'000, 1'000'000)->Unit(benchmark::kMillisecond);
+
+
+/// <summary>
+/// range(0) is the size of the Factorizer table, range(1) is the upper bound of factorized numbers
+/// </summary>
+static void BM_FactorizerFactorize(benchmark::State& state) {
+	NumberTheory::Factorizer factorizer;
+	factorizer.build(state.range(0));
+	std::mt19937_64 generator(42);
+	std::vector<size_t> numbers(1 << 10);
+	std::generate(numbers.begin(), numbers.end(), [&generator, &state]() { return generator() % (state.range(1) - 2) + 2; });
+	for (auto _ : state) {
+		for (auto number : numbers) {
+			benchmark::DoNotOptimize(factorizer.factorize(number));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * numbers.size());
+}
+BENCHMARK(BM_FactorizerFactorize)->Args({ 1'000'000, 1'000'000 })->Args({ 1'000'000, 1'000'000'000 })->Unit(benchmark::kMicrosecond);
+
+
+template <class T>
+static void BM_SparseTableBuild(benchmark::State& state) {
+	auto values = get_random_values<T>(state.range(0));
+	for (auto _ : state) {
+		SparseTable<T> sparse_table(values, sum<T>);
+		benchmark::DoNotOptimize(sparse_table.get_count_of_levels());
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+template <class T>
+static void BM_SparseTableQuery(benchmark::State& state) {
+	auto values = get_random_values<T>(state.range(0));
+	auto segments = get_random_segments(values.size());
+	SparseTable<T> sparse_table(values, sum<T>);
+	for (auto _ : state) {
+		for (const auto& [l, r] : segments) {
+			benchmark::DoNotOptimize(sparse_table.ask_value(l, r));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * segments.size());
+}
+
+template <class T>
+static void BM_SparseTableWithIdempotencyQuery(benchmark::State& state) {
+	auto values = get_random_values<T>(state.range(0));
+	auto segments = get_random_segments(values.size());
+	SparseTableWithIdempotency<T> sparse_table(values, [](const T& a, const T& b) { return std::min(a, b); });
+	for (auto _ : state) {
+		for (const auto& [l, r] : segments) {
+			benchmark::DoNotOptimize(sparse_table.ask_value(l, r));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * segments.size());
+}
+
+template <class T>
+static void BM_SegmentTreeBuild(benchmark::State& state) {
+	auto values = get_random_values<T>(state.range(0));
+	for (auto _ : state) {
+		SegmentTree<T> segment_tree(values, sum<T>);
+		benchmark::DoNotOptimize(segment_tree.ask_value_on(0, 0));
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+template <class T>
+static void BM_SegmentTreeQuery(benchmark::State& state) {
+	auto values = get_random_values<T>(state.range(0));
+	auto segments = get_random_segments(values.size());
+	SegmentTree<T> segment_tree(values, sum<T>);
+	for (auto _ : state) {
+		for (const auto& [l, r] : segments) {
+			benchmark::DoNotOptimize(segment_tree.ask_value_on(l, r));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * segments.size());
+}
+
+template <class T>
+static void BM_SegmentTreeUpdate(benchmark::State& state) {
+	auto values = get_random_values<T>(state.range(0));
+	auto segments = get_random_segments(values.size());
+	SegmentTree<T> segment_tree(values, sum<T>);
+	for (auto _ : state) {
+		for (const auto& [position, value] : segments) {
+			segment_tree.change_value(position, (T)value);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * segments.size());
+}
+
+template <class T>
+static void BM_RootDecompositionBuild(benchmark::State& state) {
+	auto values = get_random_values<T>(state.range(0));
+	for (auto _ : state) {
+		RootDecomposition<T> root_decomposition(values, sum<T>);
+		benchmark::DoNotOptimize(root_decomposition.get_length());
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+template <class T>
+static void BM_RootDecompositionQuery(benchmark::State& state) {
+	auto values = get_random_values<T>(state.range(0));
+	auto segments = get_random_segments(values.size());
+	RootDecomposition<T> root_decomposition(values, sum<T>);
+	for (auto _ : state) {
+		for (const auto& [l, r] : segments) {
+			benchmark::DoNotOptimize(root_decomposition.get_result_on(l, r));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * segments.size());
+}
+
+template <class T>
+static void BM_PrefixAmountsBuild(benchmark::State& state) {
+	auto values = get_random_values<T>(state.range(0));
+	for (auto _ : state) {
+		PrefixAmounts<T> prefix_amounts(values);
+		benchmark::DoNotOptimize(prefix_amounts.size());
+	}
+	state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+template <class T>
+static void BM_PrefixAmountsQuery(benchmark::State& state) {
+	auto values = get_random_values<T>(state.range(0));
+	auto segments = get_random_segments(values.size());
+	PrefixAmounts<T> prefix_amounts(values);
+	for (auto _ : state) {
+		for (const auto& [l, r] : segments) {
+			benchmark::DoNotOptimize(prefix_amounts.ask(l, r));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * segments.size());
+}
+
+#define QUERY_STRUCTURE_BENCHMARK(function, type) \
+	BENCHMARK_TEMPLATE(function, type)->RangeMultiplier(10)->Range(1'000, 1'000'000)
+
+QUERY_STRUCTURE_BENCHMARK(BM_SparseTableBuild, int);
+QUERY_STRUCTURE_BENCHMARK(BM_SparseTableBuild, long long);
+QUERY_STRUCTURE_BENCHMARK(BM_SparseTableBuild, double);
+QUERY_STRUCTURE_BENCHMARK(BM_SparseTableQuery, int);
+QUERY_STRUCTURE_BENCHMARK(BM_SparseTableQuery, long long);
+QUERY_STRUCTURE_BENCHMARK(BM_SparseTableQuery, double);
+QUERY_STRUCTURE_BENCHMARK(BM_SparseTableWithIdempotencyQuery, int);
+QUERY_STRUCTURE_BENCHMARK(BM_SparseTableWithIdempotencyQuery, double);
+QUERY_STRUCTURE_BENCHMARK(BM_SegmentTreeBuild, int);
+QUERY_STRUCTURE_BENCHMARK(BM_SegmentTreeBuild, long long);
+QUERY_STRUCTURE_BENCHMARK(BM_SegmentTreeBuild, double);
+QUERY_STRUCTURE_BENCHMARK(BM_SegmentTreeQuery, int);
+QUERY_STRUCTURE_BENCHMARK(BM_SegmentTreeQuery, long long);
+QUERY_STRUCTURE_BENCHMARK(BM_SegmentTreeQuery, double);
+QUERY_STRUCTURE_BENCHMARK(BM_SegmentTreeUpdate, int);
+QUERY_STRUCTURE_BENCHMARK(BM_SegmentTreeUpdate, double);
+QUERY_STRUCTURE_BENCHMARK(BM_RootDecompositionBuild, int);
+QUERY_STRUCTURE_BENCHMARK(BM_RootDecompositionBuild, long long);
+QUERY_STRUCTURE_BENCHMARK(BM_RootDecompositionBuild, double);
+QUERY_STRUCTURE_BENCHMARK(BM_RootDecompositionQuery, int);
+QUERY_STRUCTURE_BENCHMARK(BM_RootDecompositionQuery, long long);
+QUERY_STRUCTURE_BENCHMARK(BM_RootDecompositionQuery, double);
+QUERY_STRUCTURE_BENCHMARK(BM_PrefixAmountsBuild, int);
+QUERY_STRUCTURE_BENCHMARK(BM_PrefixAmountsBuild, long long);
+QUERY_STRUCTURE_BENCHMARK(BM_PrefixAmountsBuild, double);
+QUERY_STRUCTURE_BENCHMARK(BM_PrefixAmountsQuery, int);
+QUERY_STRUCTURE_BENCHMARK(BM_PrefixAmountsQuery, long long);
+QUERY_STRUCTURE_BENCHMARK(BM_PrefixAmountsQuery, double);
+
+
+int main(int argc, char** argv) {
+	std::vector<char*> arguments(argv, argv + argc);
+	std::string json_format = "--benchmark_format=json";
+	arguments.insert(arguments.begin() + 1, json_format.data()); // flags given by the user come later and win
+	int count_of_arguments = (int)arguments.size();
+	::benchmark::Initialize(&count_of_arguments, arguments.data());
+	if (::benchmark::ReportUnrecognizedArguments(count_of_arguments, arguments.data())) {
+		return 1;
+	}
+	::benchmark::RunSpecifiedBenchmarks();
+	::benchmark::Shutdown();
+	return 0;
+}
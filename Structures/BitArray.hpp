@@ -1,5 +1,6 @@
 #pragma once
 #include <cstring>
+#include <memory_resource>
 
 typedef int container;
 const container degrees[] = { (1 << 0), (1 << 1), (1 << 2), (1 << 3), (1 << 4), (1 << 5), (1 << 6), (1 << 7),
@@ -15,6 +16,21 @@ class BitArray {
 private:
 	int _size;
 	container* ptr;
+	std::pmr::memory_resource* resource;
+
+	void allocate() {
+		this->ptr = nullptr;
+		if (this->get_count_of_containers() > 0) {
+			this->ptr = static_cast<container*>(this->resource->allocate(sizeof(container) * this->get_count_of_containers(), alignof(container)));
+		}
+	}
+
+	void deallocate() {
+		if (this->ptr != nullptr) {
+			this->resource->deallocate(this->ptr, sizeof(container) * this->get_count_of_containers(), alignof(container));
+			this->ptr = nullptr;
+		}
+	}
 public:
 	static void set_true_bit(container& n, int position) {
 		n |= degrees[position];
@@ -27,32 +43,73 @@ public:
 		return (n >> position) & one;
 	}
 
-	BitArray(int size = 0, bool default_value = false) : _size(size) {
-		int num_arrays = ((size + for_mod) >> main_degree);
-		ptr = new container[num_arrays];
+	BitArray(int size = 0, bool default_value = false, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+		_size(size), resource(resource) {
+		this->allocate();
+		int num_arrays = this->get_count_of_containers();
 
 		container default_val = -default_value;
 		for (int i = 0; i < num_arrays; ++i) {
 			this->ptr[i] = default_val;
 		}
 	}
-	BitArray(const BitArray& other) {
-		this->_size = other._size;
-		this->ptr = new container[this->_size];
-		std::memcpy(this->ptr, other.ptr, sizeof(container) * this->_size);
+	/// <summary>
+	/// like std::pmr containers, a copy uses the default memory resource
+	/// </summary>
+	BitArray(const BitArray& other) : BitArray(other, std::pmr::get_default_resource()) {}
+	BitArray(const BitArray& other, std::pmr::memory_resource* resource) : _size(other._size), resource(resource) {
+		this->allocate();
+		if (this->ptr != nullptr) {
+			std::memcpy(this->ptr, other.ptr, sizeof(container) * this->get_count_of_containers());
+		}
 	}
-	BitArray(BitArray&& other) noexcept {
-		this->_size = other._size;
-		this->ptr = other.ptr;
+	BitArray(BitArray&& other) noexcept : _size(other._size), ptr(other.ptr), resource(other.resource) {
+		other._size = 0;
 		other.ptr = nullptr;
 	}
-	BitArray& operator=(const BitArray& other) = default;
-	BitArray& operator=(BitArray&& other) noexcept = default;
+	BitArray& operator=(const BitArray& other) {
+		if (this != &other) {
+			this->deallocate();
+			this->_size = other._size;
+			this->allocate();
+			if (this->ptr != nullptr) {
+				std::memcpy(this->ptr, other.ptr, sizeof(container) * this->get_count_of_containers());
+			}
+		}
+		return *this;
+	}
+	BitArray& operator=(BitArray&& other) noexcept {
+		if (this != &other) {
+			if (this->resource->is_equal(*other.resource)) {
+				this->deallocate();
+				this->_size = other._size;
+				this->ptr = other.ptr;
+				other._size = 0;
+				other.ptr = nullptr;
+			}
+			else {
+				*this = other;
+			}
+		}
+		return *this;
+	}
 
 	int size() const {
 		return this->_size;
 	}
 
+	int get_count_of_containers() const {
+		return ((this->_size + for_mod) >> main_degree);
+	}
+
+	container get_container(int index) const {
+		return ptr[index];
+	}
+
+	std::pmr::memory_resource* get_memory_resource() const {
+		return this->resource;
+	}
+
 	bool operator[](int index) const {
 		return get_bit(ptr[(index >> main_degree)], index & for_mod);
 	}
@@ -66,15 +123,22 @@ public:
 	}
 
 	~BitArray() {
-		delete[] this->ptr;
+		this->deallocate();
 	}
 
 	BitArray operator+(const BitArray& other) const {
-		BitArray answer;
-		answer._size = this->size() + other.size();
-		answer.ptr = new container[answer.size()];
-		memcpy(answer.ptr, this->ptr, sizeof(container) * this->size());
-		memcpy(answer.ptr + this->size(), other.ptr, sizeof(container) * other.size());
+		BitArray answer(this->size() + other.size(), false, this->resource);
+		if (this->ptr != nullptr) {
+			std::memcpy(answer.ptr, this->ptr, sizeof(container) * this->get_count_of_containers());
+		}
+		for (int i = 0; i < other.size(); ++i) {
+			if (other[i]) {
+				answer.set_true(this->size() + i);
+			}
+			else {
+				answer.set_false(this->size() + i);
+			}
+		}
 		return answer;
 	}
 };
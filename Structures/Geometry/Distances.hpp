@@ -0,0 +1,190 @@
+#pragma once
+#include <span>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "PointCloud.hpp"
+#include "FixedPointVector.hpp"
+#include "../Parallel.hpp"
+
+namespace Geometry {
+    /// <summary>
+    /// out[i * cols.size() + j] = squared distance (or distance if take_root) from point i of rows to point j of cols.
+    /// The matrix is computed in tiles of row_tile x col_tile: the coordinates of a tile of columns stay in L1
+    /// while all rows of the tile are compared with them, and every inner loop runs over contiguous coordinates and vectorizes.
+    /// Tiles of rows are split between threads_count threads, 0 means all hardware threads.
+    /// </summary>
+    template <bool take_root, class T, std::size_t Dimension>
+    void compute_distance_matrix(const PointCloud<T, Dimension>& rows, const PointCloud<T, Dimension>& cols, T* out, std::size_t threads_count) {
+        constexpr std::size_t row_tile = 16;
+        constexpr std::size_t col_tile = 4096 / sizeof(T);
+        std::size_t n = rows.size(), m = cols.size();
+        std::size_t row_tiles_count = (n + row_tile - 1) / row_tile;
+        Parallel::parallel_for(0, row_tiles_count, threads_count, [&](std::size_t first_tile, std::size_t last_tile) {
+            for (std::size_t tile = first_tile; tile < last_tile; ++tile) {
+                std::size_t first_row = tile * row_tile, last_row = std::min(first_row + row_tile, n);
+                for (std::size_t first_col = 0; first_col < m; first_col += col_tile) {
+                    std::size_t length = std::min(col_tile, m - first_col);
+                    for (std::size_t i = first_row; i < last_row; ++i) {
+                        T* row = out + i * m + first_col;
+                        for (std::size_t j = 0; j < length; ++j) {
+                            row[j] = 0;
+                        }
+                        for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                            const T* values = cols.coordinate(axis) + first_col;
+                            T center = rows.coordinate(axis)[i];
+                            for (std::size_t j = 0; j < length; ++j) {
+                                T difference = values[j] - center;
+                                row[j] += difference * difference;
+                            }
+                        }
+                        if constexpr (take_root) {
+                            for (std::size_t j = 0; j < length; ++j) {
+                                row[j] = std::sqrt(row[j]);
+                            }
+                        }
+                    }
+                }
+            }
+        }, 4);
+    }
+
+    /// <summary>
+    /// out[i * cols.size() + j] = squared distance from point i of rows to point j of cols,
+    /// out must have rows.size() * cols.size() elements
+    /// </summary>
+    /// <remarks>
+    /// Asymptotics: O(N M Dimension), no allocations.
+    /// </remarks>
+    template <class T, std::size_t Dimension>
+    void squared_distance_matrix(const PointCloud<T, Dimension>& rows, const PointCloud<T, Dimension>& cols, T* out, std::size_t threads_count = 1) {
+        compute_distance_matrix<false>(rows, cols, out, threads_count);
+    }
+
+    /// <summary>
+    /// out[i * cols.size() + j] = distance from point i of rows to point j of cols,
+    /// out must have rows.size() * cols.size() elements
+    /// </summary>
+    template <class T, std::size_t Dimension>
+    void distance_matrix(const PointCloud<T, Dimension>& rows, const PointCloud<T, Dimension>& cols, T* out, std::size_t threads_count = 1) {
+        compute_distance_matrix<true>(rows, cols, out, threads_count);
+    }
+
+    template <class T>
+    struct ClosestPair {
+        std::size_t first;
+        std::size_t second;
+        T squared_distance;
+    };
+
+    /// <summary>
+    /// The ClosestPairFinder class finds the two nearest points of a plane set by divide and conquer:
+    /// the halves split by x are solved recursively, merged by y,
+    /// and only points of the strip around the split line are compared across the halves.
+    /// </summary>
+    /// <remarks>
+    /// Asymptotics: O(N log N) time, O(N) memory.
+    /// </remarks>
+    template <class T>
+    class ClosestPairFinder {
+    private:
+        struct Item {
+            T x, y;
+            std::size_t index;
+        };
+
+        std::vector<Item> items;
+        std::vector<Item> buffer;
+
+        static constexpr std::size_t min_parallel_length = 1 << 14;
+
+        static void update(ClosestPair<T>& best, const Item& a, const Item& b) {
+            T dx = a.x - b.x, dy = a.y - b.y;
+            T squared_distance = dx * dx + dy * dy;
+            if (squared_distance < best.squared_distance) {
+                best = { std::min(a.index, b.index), std::max(a.index, b.index), squared_distance };
+            }
+        }
+
+        /// <summary>
+        /// solves [l, r) sorted by x and leaves it sorted by y
+        /// </summary>
+        ClosestPair<T> solve(std::size_t l, std::size_t r, std::size_t threads_count) {
+            auto by_y = [](const Item& a, const Item& b) {
+                return a.y < b.y;
+            };
+            ClosestPair<T> best = { 0, 0, std::numeric_limits<T>::max() };
+            if (r - l <= 3) {
+                for (std::size_t i = l; i < r; ++i) {
+                    for (std::size_t j = i + 1; j < r; ++j) {
+                        update(best, this->items[i], this->items[j]);
+                    }
+                }
+                std::sort(this->items.begin() + l, this->items.begin() + r, by_y);
+                return best;
+            }
+            std::size_t m = (l + r) / 2;
+            T middle_x = this->items[m].x;
+            ClosestPair<T> left, right;
+            if (threads_count > 1 && r - l >= min_parallel_length) {
+                std::thread left_thread([&]() {
+                    left = solve(l, m, threads_count / 2);
+                });
+                right = solve(m, r, threads_count - threads_count / 2);
+                left_thread.join();
+            }
+            else {
+                left = solve(l, m, 1);
+                right = solve(m, r, 1);
+            }
+            best = left.squared_distance <= right.squared_distance ? left : right;
+
+            std::merge(this->items.begin() + l, this->items.begin() + m, this->items.begin() + m, this->items.begin() + r, this->buffer.begin() + l, by_y);
+            std::copy(this->buffer.begin() + l, this->buffer.begin() + r, this->items.begin() + l);
+
+            std::size_t strip_end = l; // the strip is collected in buffer[l, strip_end), which is free now
+            for (std::size_t i = l; i < r; ++i) {
+                T dx = this->items[i].x - middle_x;
+                if (dx * dx < best.squared_distance) {
+                    for (std::size_t j = strip_end; j-- > l;) {
+                        T dy = this->items[i].y - this->buffer[j].y;
+                        if (dy * dy >= best.squared_distance) {
+                            break;
+                        }
+                        update(best, this->items[i], this->buffer[j]);
+                    }
+                    this->buffer[strip_end++] = this->items[i];
+                }
+            }
+            return best;
+        }
+
+    public:
+        /// <param name="threads_count">the two halves of large ranges are solved by different threads, 0 means all hardware threads</param>
+        ClosestPair<T> find(std::span<const PointVector<T, 2>> points, std::size_t threads_count = 1) {
+            if (points.size() < 2) {
+                throw std::invalid_argument("At least two points are required");
+            }
+            this->items.resize(points.size());
+            this->buffer.resize(points.size());
+            for (std::size_t i = 0; i < points.size(); ++i) {
+                this->items[i] = { points[i].x(), points[i].y(), i };
+            }
+            std::sort(this->items.begin(), this->items.end(), [](const Item& a, const Item& b) {
+                return a.x < b.x;
+            });
+            return this->solve(0, this->items.size(), Parallel::get_threads_count(threads_count));
+        }
+    };
+
+    /// <summary>
+    /// indices (first &lt; second) and squared distance of the two nearest points, see ClosestPairFinder
+    /// </summary>
+    template <class T>
+    ClosestPair<T> closest_pair(std::span<const PointVector<T, 2>> points, std::size_t threads_count = 1) {
+        return ClosestPairFinder<T>().find(points, threads_count);
+    }
+}
@@ -0,0 +1,287 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <string>
+#include <functional>
+#include <type_traits>
+#include "PointVector.hpp"
+
+namespace Geometry {
+    /// <summary>
+    /// Base of PointVector&lt;T, N&gt; and of lazy expressions over it.
+    /// Arithmetic on expressions only builds a description of the computation,
+    /// coordinates are evaluated once, when the expression is assigned to a PointVector,
+    /// so chains like a + b * s - c produce no temporary vectors.
+    /// </summary>
+    /// <remarks>
+    /// Expressions keep references to the PointVector operands,
+    /// so they must be evaluated before the operands are destroyed (do not store them in auto variables).
+    /// </remarks>
+    template <class Expression>
+    class PointVectorExpression {
+    public:
+        constexpr const Expression& self() const {
+            return static_cast<const Expression&>(*this);
+        }
+    };
+
+    /// <summary>
+    /// PointVector operands are kept by reference, nested expressions are kept by value
+    /// </summary>
+    template <class Expression>
+    struct ExpressionOperand {
+        using type = const Expression;
+    };
+
+    template <class T, std::size_t Dimension>
+    struct ExpressionOperand<PointVector<T, Dimension>> {
+        using type = const PointVector<T, Dimension>&;
+    };
+
+    template <class Left, class Right, class Operation>
+    class PointVectorBinaryExpression : public PointVectorExpression<PointVectorBinaryExpression<Left, Right, Operation>> {
+        static_assert(Left::dimension == Right::dimension, "Dimensions of vectors do not match");
+
+    private:
+        typename ExpressionOperand<Left>::type left;
+        typename ExpressionOperand<Right>::type right;
+
+    public:
+        using value_type = typename Left::value_type;
+        static constexpr std::size_t dimension = Left::dimension;
+
+        constexpr PointVectorBinaryExpression(const Left& left, const Right& right) : left(left), right(right) {}
+
+        constexpr value_type operator[](std::size_t index) const {
+            return Operation{}(this->left[index], this->right[index]);
+        }
+    };
+
+    template <class Argument, class Operation>
+    class PointVectorScalarExpression : public PointVectorExpression<PointVectorScalarExpression<Argument, Operation>> {
+    public:
+        using value_type = typename Argument::value_type;
+        static constexpr std::size_t dimension = Argument::dimension;
+
+    private:
+        typename ExpressionOperand<Argument>::type argument;
+        value_type scalar;
+
+    public:
+        constexpr PointVectorScalarExpression(const Argument& argument, const value_type& scalar) : argument(argument), scalar(scalar) {}
+
+        constexpr value_type operator[](std::size_t index) const {
+            return Operation{}(this->argument[index], this->scalar);
+        }
+    };
+
+    template <class Argument>
+    class PointVectorNegation : public PointVectorExpression<PointVectorNegation<Argument>> {
+    private:
+        typename ExpressionOperand<Argument>::type argument;
+
+    public:
+        using value_type = typename Argument::value_type;
+        static constexpr std::size_t dimension = Argument::dimension;
+
+        constexpr PointVectorNegation(const Argument& argument) : argument(argument) {}
+
+        constexpr value_type operator[](std::size_t index) const {
+            return -this->argument[index];
+        }
+    };
+
+    template <class Left, class Right>
+    constexpr auto operator+(const PointVectorExpression<Left>& left, const PointVectorExpression<Right>& right) {
+        return PointVectorBinaryExpression<Left, Right, std::plus<>>(left.self(), right.self());
+    }
+
+    template <class Left, class Right>
+    constexpr auto operator-(const PointVectorExpression<Left>& left, const PointVectorExpression<Right>& right) {
+        return PointVectorBinaryExpression<Left, Right, std::minus<>>(left.self(), right.self());
+    }
+
+    template <class Argument>
+    constexpr auto operator-(const PointVectorExpression<Argument>& argument) {
+        return PointVectorNegation<Argument>(argument.self());
+    }
+
+    template <class Argument>
+    constexpr auto operator*(const PointVectorExpression<Argument>& argument, const typename Argument::value_type& factor) {
+        return PointVectorScalarExpression<Argument, std::multiplies<>>(argument.self(), factor);
+    }
+
+    template <class Argument>
+    constexpr auto operator*(const typename Argument::value_type& factor, const PointVectorExpression<Argument>& argument) {
+        return PointVectorScalarExpression<Argument, std::multiplies<>>(argument.self(), factor);
+    }
+
+    template <class Argument>
+    constexpr auto operator/(const PointVectorExpression<Argument>& argument, const typename Argument::value_type& scalar) {
+        return PointVectorScalarExpression<Argument, std::divides<>>(argument.self(), scalar);
+    }
+}
+
+/// <summary>
+/// PointVector with the dimension fixed at compile time: coordinates live in a std::array,
+/// arithmetic is constexpr and lazy (see Geometry::PointVectorExpression),
+/// dimensions are checked by the compiler, and the type is trivially copyable,
+/// so it can be stored in flat arrays and copied with memcpy.
+/// </summary>
+template <class T, std::size_t Dimension>
+    requires (Dimension != std::dynamic_extent)
+class PointVector<T, Dimension> : public Geometry::PointVectorExpression<PointVector<T, Dimension>> {
+private:
+    std::array<T, Dimension> coordinates;
+
+public:
+    using value_type = T;
+    static constexpr std::size_t dimension = Dimension;
+
+    constexpr PointVector() : coordinates{} {}
+
+    template <class... Coordinates>
+        requires (sizeof...(Coordinates) == Dimension && (std::is_convertible_v<Coordinates, T> && ...))
+    constexpr PointVector(Coordinates... coordinates) : coordinates{ static_cast<T>(coordinates)... } {}
+
+    constexpr PointVector(const std::array<T, Dimension>& coordinates) : coordinates(coordinates) {}
+
+    template <class Expression>
+    constexpr PointVector(const Geometry::PointVectorExpression<Expression>& expression) : coordinates{} {
+        *this = expression;
+    }
+
+    /// <summary>
+    /// every coordinate of an expression depends only on the same coordinates of the operands,
+    /// so the expression can be evaluated in place even if it contains this vector
+    /// </summary>
+    template <class Expression>
+    constexpr PointVector& operator=(const Geometry::PointVectorExpression<Expression>& expression) {
+        static_assert(Expression::dimension == Dimension, "Dimensions of vectors do not match");
+        for (std::size_t i = 0; i < Dimension; ++i) {
+            this->coordinates[i] = expression.self()[i];
+        }
+        return *this;
+    }
+
+    template <class Expression>
+    constexpr PointVector& operator+=(const Geometry::PointVectorExpression<Expression>& expression) {
+        return *this = *this + expression;
+    }
+
+    template <class Expression>
+    constexpr PointVector& operator-=(const Geometry::PointVectorExpression<Expression>& expression) {
+        return *this = *this - expression;
+    }
+
+    constexpr PointVector& operator*=(const T& factor) {
+        return *this = *this * factor;
+    }
+
+    constexpr PointVector& operator/=(const T& scalar) {
+        return *this = *this / scalar;
+    }
+
+    std::string toString() const {
+        std::string result = "PointVector{";
+        for (const auto& coord : coordinates) {
+            result += std::to_string(coord) + ", ";
+        }
+        result.pop_back();
+        result.pop_back();
+        result += "}";
+        return result;
+    }
+
+    static constexpr std::size_t size() {
+        return Dimension;
+    }
+
+    constexpr T operator[](std::size_t index) const {
+        return coordinates[index];
+    }
+
+    constexpr T& operator[](std::size_t index) {
+        return coordinates[index];
+    }
+
+    constexpr bool operator==(const PointVector& other) const {
+        for (std::size_t i = 0; i < Dimension; ++i) {
+            if (coordinates[i] != other.coordinates[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const PointVector& other) const {
+        return !(*this == other);
+    }
+
+    constexpr T x() const requires (Dimension >= 1) {
+        return coordinates[0];
+    }
+
+    constexpr T y() const requires (Dimension >= 2) {
+        return coordinates[1];
+    }
+
+    constexpr T z() const requires (Dimension >= 3) {
+        return coordinates[2];
+    }
+
+    constexpr T& x() requires (Dimension >= 1) {
+        return coordinates[0];
+    }
+
+    constexpr T& y() requires (Dimension >= 2) {
+        return coordinates[1];
+    }
+
+    constexpr T& z() requires (Dimension >= 3) {
+        return coordinates[2];
+    }
+
+    template <class Expression>
+    constexpr T dotProduct(const Geometry::PointVectorExpression<Expression>& other) const {
+        static_assert(Expression::dimension == Dimension, "Dimensions of vectors do not match");
+        T sum = 0;
+        for (std::size_t i = 0; i < Dimension; ++i) {
+            sum += coordinates[i] * other.self()[i];
+        }
+        return sum;
+    }
+
+    constexpr PointVector crossProduct(const PointVector& other) const requires (Dimension == 3) {
+        return PointVector(
+            coordinates[1] * other.coordinates[2] - coordinates[2] * other.coordinates[1],
+            coordinates[2] * other.coordinates[0] - coordinates[0] * other.coordinates[2],
+            coordinates[0] * other.coordinates[1] - coordinates[1] * other.coordinates[0]
+        );
+    }
+
+    constexpr T squaredMagnitude() const {
+        return this->dotProduct(*this);
+    }
+
+    T magnitude() const {
+        return std::sqrt(this->squaredMagnitude());
+    }
+
+    PointVector normalize() const {
+        return *this / this->magnitude();
+    }
+
+    template <class Expression>
+    T distance(const Geometry::PointVectorExpression<Expression>& other) const {
+        PointVector difference = *this - other;
+        return difference.magnitude();
+    }
+
+    constexpr const std::array<T, Dimension>& getCoordinates() const {
+        return this->coordinates;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<PointVector<double, 3>>, "PointVector<T, N> must be trivially copyable");
+static_assert(sizeof(PointVector<double, 3>) == 3 * sizeof(double), "PointVector<T, N> must have no overhead");
@@ -1,3 +1,10 @@
 #pragma once
 #include "MathPointVector2D.hpp"
 #include "PointVector.hpp"
+#include "PointCloud.hpp"
+#include "FixedPointVector.hpp"
+#include "KDTree.hpp"
+#include "PointHashMap.hpp"
+#include "IntegerGeometry.hpp"
+#include "Transforms.hpp"
+#include "Distances.hpp"
@@ -0,0 +1,210 @@
+#pragma once
+#include <span>
+#include <mutex>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <memory_resource>
+#include "MathPointVector2D.hpp"
+#include "../Parallel.hpp"
+
+/// <summary>
+/// Exact predicates and algorithms on MathPointVector2DOnInt.
+/// Any int coordinates are allowed: differences are computed in 64 bits and their products in 128 bits,
+/// so no predicate can overflow.
+/// </summary>
+namespace Geometry {
+    /// <summary>
+    /// (a - o) x (b - o)
+    /// </summary>
+    inline __int128 cross(const MathPointVector2DOnInt& o, const MathPointVector2DOnInt& a, const MathPointVector2DOnInt& b) {
+        long long ax = (long long)a.get_x() - o.get_x(), ay = (long long)a.get_y() - o.get_y();
+        long long bx = (long long)b.get_x() - o.get_x(), by = (long long)b.get_y() - o.get_y();
+        return (__int128)ax * by - (__int128)ay * bx;
+    }
+
+    /// <summary>
+    /// 1 if o, a, b make a counterclockwise turn, -1 if clockwise, 0 if they are collinear
+    /// </summary>
+    inline int orientation(const MathPointVector2DOnInt& o, const MathPointVector2DOnInt& a, const MathPointVector2DOnInt& b) {
+        auto value = cross(o, a, b);
+        return (value > 0) - (value < 0);
+    }
+
+    inline bool less_xy(const MathPointVector2DOnInt& a, const MathPointVector2DOnInt& b) {
+        return a.get_x() < b.get_x() || (a.get_x() == b.get_x() && a.get_y() < b.get_y());
+    }
+
+    /// <summary>
+    /// doubled signed area of the polygon, positive if the vertices go counterclockwise
+    /// </summary>
+    inline __int128 doubled_area(std::span<const MathPointVector2DOnInt> polygon) {
+        __int128 area = 0;
+        for (std::size_t i = 0; i < polygon.size(); ++i) {
+            const auto& current = polygon[i];
+            const auto& next = polygon[i + 1 == polygon.size() ? 0 : i + 1];
+            area += (__int128)current.get_x() * next.get_y() - (__int128)current.get_y() * next.get_x();
+        }
+        return area;
+    }
+
+    /// <summary>
+    /// true if point lies on the closed segment [a, b]
+    /// </summary>
+    inline bool on_segment(const MathPointVector2DOnInt& a, const MathPointVector2DOnInt& b, const MathPointVector2DOnInt& point) {
+        return cross(a, b, point) == 0 &&
+            std::min(a.get_x(), b.get_x()) <= point.get_x() && point.get_x() <= std::max(a.get_x(), b.get_x()) &&
+            std::min(a.get_y(), b.get_y()) <= point.get_y() && point.get_y() <= std::max(a.get_y(), b.get_y());
+    }
+
+    /// <summary>
+    /// true if the closed segments [a, b] and [c, d] have a common point
+    /// </summary>
+    inline bool segments_intersect(const MathPointVector2DOnInt& a, const MathPointVector2DOnInt& b, const MathPointVector2DOnInt& c, const MathPointVector2DOnInt& d) {
+        int abc = orientation(a, b, c), abd = orientation(a, b, d);
+        int cda = orientation(c, d, a), cdb = orientation(c, d, b);
+        if (abc * abd < 0 && cda * cdb < 0) {
+            return true;
+        }
+        return on_segment(a, b, c) || on_segment(a, b, d) || on_segment(c, d, a) || on_segment(c, d, b);
+    }
+
+    /// <summary>
+    /// Andrew's monotone chain on points sorted by less_xy.
+    /// Writes the hull into hull counterclockwise starting from the smallest point, without collinear points,
+    /// and returns its size. hull must have at least points.size() elements.
+    /// </summary>
+    inline std::size_t convex_hull_of_sorted(std::span<const MathPointVector2DOnInt> points, std::span<MathPointVector2DOnInt> hull) {
+        std::size_t n = points.size();
+        if (n <= 1) {
+            std::copy(points.begin(), points.end(), hull.begin());
+            return n;
+        }
+        // the lower chain only takes points on or below the line from the first point to the last one,
+        // the upper chain only takes points above it, so every point is stored at most once
+        const auto& first = points[0];
+        const auto& last = points[n - 1];
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (cross(first, last, points[i]) > 0) {
+                continue;
+            }
+            while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+                --k;
+            }
+            hull[k++] = points[i];
+        }
+        std::size_t lower_size = k;
+        for (std::size_t i = n - 1; i-- > 1;) {
+            if (cross(first, last, points[i]) <= 0) {
+                continue;
+            }
+            while (k > lower_size && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+                --k;
+            }
+            hull[k++] = points[i];
+        }
+        while (k > lower_size && cross(hull[k - 2], hull[k - 1], points[0]) <= 0) {
+            --k; // the chain is closed by points[0] without storing it again
+        }
+        if (k == 2 && hull[0] == hull[1]) {
+            k = 1;
+        }
+        return k;
+    }
+
+    /// <summary>
+    /// Convex hull of points, see convex_hull_of_sorted. points is used as scratch space and is reordered.
+    /// </summary>
+    /// <param name="hull">must have at least points.size() elements</param>
+    /// <param name="threads_count">
+    /// points are split into chunks that are sorted and reduced to their hulls in parallel,
+    /// then the hull of the union of the chunk hulls is built, 0 means all hardware threads
+    /// </param>
+    /// <remarks>
+    /// Asymptotics: O(N log N).
+    /// </remarks>
+    inline std::size_t convex_hull(std::span<MathPointVector2DOnInt> points, std::span<MathPointVector2DOnInt> hull, std::size_t threads_count = 1) {
+        std::vector<std::pair<std::size_t, std::size_t>> chunk_hulls; // begin and size of the hull of every chunk in hull
+        std::mutex chunk_hulls_mutex;
+        Parallel::parallel_for(0, points.size(), threads_count, [&](std::size_t l, std::size_t r) {
+            std::sort(points.begin() + l, points.begin() + r, less_xy);
+            if (l == 0 && r == points.size()) {
+                chunk_hulls.push_back({ 0, 0 });
+                return;
+            }
+            std::size_t size = convex_hull_of_sorted(points.subspan(l, r - l), hull.subspan(l, r - l));
+            std::lock_guard<std::mutex> lock(chunk_hulls_mutex);
+            chunk_hulls.push_back({ l, size });
+        });
+        if (chunk_hulls.size() > 1) {
+            std::sort(chunk_hulls.begin(), chunk_hulls.end());
+            std::size_t m = 0;
+            for (auto [begin, size] : chunk_hulls) {
+                m = std::copy(hull.begin() + begin, hull.begin() + begin + size, points.begin() + m) - points.begin();
+            }
+            points = points.first(m);
+            std::sort(points.begin(), points.end(), less_xy);
+        }
+        return convex_hull_of_sorted(points, hull);
+    }
+
+    inline std::vector<MathPointVector2DOnInt> convex_hull(std::vector<MathPointVector2DOnInt> points, std::size_t threads_count = 1) {
+        std::vector<MathPointVector2DOnInt> hull(points.size());
+        hull.resize(convex_hull(points, hull, threads_count));
+        return hull;
+    }
+
+    /// <summary>
+    /// The ConvexPolygonIndex class answers point-in-polygon queries for a strictly convex polygon
+    /// given counterclockwise (as convex_hull returns it) by a binary search over the fan of triangles from the first vertex.
+    /// </summary>
+    /// <remarks>
+    /// Asymptotics:
+    /// - Building the data structure: O(N).
+    /// - Query operation (contains): O(log N).
+    /// </remarks>
+    class ConvexPolygonIndex {
+    private:
+        std::pmr::vector<MathPointVector2DOnInt> vertices;
+
+    public:
+        ConvexPolygonIndex(std::span<const MathPointVector2DOnInt> polygon, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+            vertices(polygon.begin(), polygon.end(), resource) {}
+
+        std::size_t size() const {
+            return this->vertices.size();
+        }
+
+        /// <summary>
+        /// true if point lies inside the polygon or on its boundary
+        /// </summary>
+        bool contains(const MathPointVector2DOnInt& point) const {
+            std::size_t n = this->vertices.size();
+            if (n == 0) {
+                return false;
+            }
+            const auto& first = this->vertices[0];
+            if (n == 1) {
+                return point == first;
+            }
+            if (n == 2) {
+                return on_segment(first, this->vertices[1], point);
+            }
+            if (cross(first, this->vertices[1], point) < 0 || cross(first, this->vertices[n - 1], point) > 0) {
+                return false;
+            }
+            std::size_t l = 1, r = n - 1; // the answer is the last i in [1, n - 1) with point to the left of first -> vertices[i]
+            while (r - l > 1) {
+                std::size_t m = (l + r) / 2;
+                if (cross(first, this->vertices[m], point) >= 0) {
+                    l = m;
+                }
+                else {
+                    r = m;
+                }
+            }
+            return cross(this->vertices[l], this->vertices[l + 1], point) >= 0;
+        }
+    };
+}
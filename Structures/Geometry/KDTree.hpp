@@ -0,0 +1,251 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <memory_resource>
+#include "PointVector.hpp"
+#include "../Parallel.hpp"
+
+namespace Geometry {
+    /// <summary>
+    /// The KDTree class is a spatial index over PointVector points
+    /// for k nearest neighbours, radius and box queries.
+    /// </summary>
+    /// <remarks>
+    /// The tree is implicit: the node of the range [l, r) of positions is the position m = (l + r) / 2,
+    /// its subtrees are [l, m) and [m + 1, r). Coordinates are stored row-major in tree order,
+    /// so a query walks one flat array.
+    /// Asymptotics:
+    /// - Building the data structure: O(N log N) with nth_element.
+    /// - Nearest neighbour query: O(log N) on average for well spread points.
+    /// </remarks>
+    template <class T>
+    class KDTree {
+    private:
+        std::size_t dimension;
+        std::size_t n;
+        std::pmr::vector<T> coordinates; // coordinates of the point at position i are [i * dimension, (i + 1) * dimension)
+        std::pmr::vector<std::size_t> indices; // index of the point at position i in the input
+        std::pmr::vector<std::size_t> split_axes; // split axis of the node at position i
+
+        using Neighbour = std::pair<T, std::size_t>; // squared distance and position
+
+        const T* get_point(std::size_t position) const {
+            return this->coordinates.data() + position * this->dimension;
+        }
+
+        T get_squared_distance(const T* a, const T* b) const {
+            T sum = 0;
+            for (std::size_t axis = 0; axis < this->dimension; ++axis) {
+                T difference = a[axis] - b[axis];
+                sum += difference * difference;
+            }
+            return sum;
+        }
+
+        void build(const std::vector<PointVector<T>>& points, std::vector<std::size_t>& order, std::size_t l, std::size_t r) {
+            if (l >= r) {
+                return;
+            }
+            std::size_t axis = 0;
+            T largest_spread = -1;
+            for (std::size_t current_axis = 0; current_axis < this->dimension; ++current_axis) {
+                auto [minimum, maximum] = std::minmax_element(order.begin() + l, order.begin() + r, [&](std::size_t i, std::size_t j) {
+                    return points[i][current_axis] < points[j][current_axis];
+                });
+                T spread = points[*maximum][current_axis] - points[*minimum][current_axis];
+                if (spread > largest_spread) {
+                    largest_spread = spread;
+                    axis = current_axis;
+                }
+            }
+            std::size_t m = (l + r) / 2;
+            std::nth_element(order.begin() + l, order.begin() + m, order.begin() + r, [&](std::size_t i, std::size_t j) {
+                return points[i][axis] < points[j][axis];
+            });
+            this->split_axes[m] = axis;
+            build(points, order, l, m);
+            build(points, order, m + 1, r);
+        }
+
+        void search_nearest(const T* query, std::size_t k, std::size_t l, std::size_t r, std::priority_queue<Neighbour>& nearest) const {
+            if (l >= r) {
+                return;
+            }
+            std::size_t m = (l + r) / 2;
+            const T* point = this->get_point(m);
+            T squared_distance = this->get_squared_distance(query, point);
+            if (nearest.size() < k) {
+                nearest.push({ squared_distance, m });
+            }
+            else if (squared_distance < nearest.top().first) {
+                nearest.pop();
+                nearest.push({ squared_distance, m });
+            }
+            std::size_t axis = this->split_axes[m];
+            T difference = query[axis] - point[axis];
+            bool left_is_near = difference < 0;
+            if (left_is_near) {
+                search_nearest(query, k, l, m, nearest);
+            }
+            else {
+                search_nearest(query, k, m + 1, r, nearest);
+            }
+            if (nearest.size() < k || difference * difference < nearest.top().first) {
+                if (left_is_near) {
+                    search_nearest(query, k, m + 1, r, nearest);
+                }
+                else {
+                    search_nearest(query, k, l, m, nearest);
+                }
+            }
+        }
+
+        void search_in_radius(const T* query, T squared_radius, std::size_t l, std::size_t r, std::vector<std::size_t>& answer) const {
+            if (l >= r) {
+                return;
+            }
+            std::size_t m = (l + r) / 2;
+            const T* point = this->get_point(m);
+            if (this->get_squared_distance(query, point) <= squared_radius) {
+                answer.push_back(this->indices[m]);
+            }
+            std::size_t axis = this->split_axes[m];
+            T difference = query[axis] - point[axis];
+            if (difference <= 0 || difference * difference <= squared_radius) {
+                search_in_radius(query, squared_radius, l, m, answer);
+            }
+            if (difference >= 0 || difference * difference <= squared_radius) {
+                search_in_radius(query, squared_radius, m + 1, r, answer);
+            }
+        }
+
+        void search_in_box(const T* minimum, const T* maximum, std::size_t l, std::size_t r, std::vector<std::size_t>& answer) const {
+            if (l >= r) {
+                return;
+            }
+            std::size_t m = (l + r) / 2;
+            const T* point = this->get_point(m);
+            bool inside = true;
+            for (std::size_t axis = 0; axis < this->dimension && inside; ++axis) {
+                inside = minimum[axis] <= point[axis] && point[axis] <= maximum[axis];
+            }
+            if (inside) {
+                answer.push_back(this->indices[m]);
+            }
+            std::size_t axis = this->split_axes[m];
+            if (minimum[axis] <= point[axis]) {
+                search_in_box(minimum, maximum, l, m, answer);
+            }
+            if (point[axis] <= maximum[axis]) {
+                search_in_box(minimum, maximum, m + 1, r, answer);
+            }
+        }
+
+        std::vector<T> get_query_coordinates(const PointVector<T>& query) const {
+            if (query.size() != this->dimension) {
+                throw std::invalid_argument("Dimensions of vectors do not match");
+            }
+            return query.getCoordinates();
+        }
+
+    public:
+        /// <param name="points">points of the same dimension, queries return indices in this vector</param>
+        /// <param name="resource">memory resource for the tree</param>
+        KDTree(const std::vector<PointVector<T>>& points, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+            dimension(points.empty() ? 0 : points[0].size()), n(points.size()), coordinates(resource), indices(resource), split_axes(resource) {
+            for (const auto& point : points) {
+                if (point.size() != this->dimension) {
+                    throw std::invalid_argument("Dimensions of vectors do not match");
+                }
+            }
+            std::vector<std::size_t> order(this->n);
+            std::iota(order.begin(), order.end(), 0);
+            this->split_axes.resize(this->n);
+            this->build(points, order, 0, this->n);
+            this->indices.assign(order.begin(), order.end());
+            this->coordinates.resize(this->n * this->dimension);
+            for (std::size_t position = 0; position < this->n; ++position) {
+                for (std::size_t axis = 0; axis < this->dimension; ++axis) {
+                    this->coordinates[position * this->dimension + axis] = points[order[position]][axis];
+                }
+            }
+        }
+
+        std::size_t size() const {
+            return this->n;
+        }
+
+        std::size_t get_dimension() const {
+            return this->dimension;
+        }
+
+        /// <summary>
+        /// indices of the k points nearest to query, from the nearest to the farthest
+        /// </summary>
+        std::vector<std::size_t> nearest(const PointVector<T>& query, std::size_t k = 1) const {
+            auto query_coordinates = this->get_query_coordinates(query);
+            std::priority_queue<Neighbour> nearest;
+            if (k > 0) {
+                this->search_nearest(query_coordinates.data(), k, 0, this->n, nearest);
+            }
+            std::vector<std::size_t> answer(nearest.size());
+            for (std::size_t i = answer.size(); i-- > 0; nearest.pop()) {
+                answer[i] = this->indices[nearest.top().second];
+            }
+            return answer;
+        }
+
+        /// <summary>
+        /// indices of all points at distance at most radius from query, in no particular order
+        /// </summary>
+        std::vector<std::size_t> in_radius(const PointVector<T>& query, T radius) const {
+            auto query_coordinates = this->get_query_coordinates(query);
+            std::vector<std::size_t> answer;
+            this->search_in_radius(query_coordinates.data(), radius * radius, 0, this->n, answer);
+            return answer;
+        }
+
+        /// <summary>
+        /// indices of all points p with minimum[i] &lt;= p[i] &lt;= maximum[i] for every axis i, in no particular order
+        /// </summary>
+        std::vector<std::size_t> in_box(const PointVector<T>& minimum, const PointVector<T>& maximum) const {
+            auto minimum_coordinates = this->get_query_coordinates(minimum);
+            auto maximum_coordinates = this->get_query_coordinates(maximum);
+            std::vector<std::size_t> answer;
+            this->search_in_box(minimum_coordinates.data(), maximum_coordinates.data(), 0, this->n, answer);
+            return answer;
+        }
+
+        /// <summary>
+        /// nearest(queries[i], k) for every i, the queries are split between threads_count threads, 0 means all hardware threads
+        /// </summary>
+        std::vector<std::vector<std::size_t>> nearest(const std::vector<PointVector<T>>& queries, std::size_t k, std::size_t threads_count) const {
+            std::vector<std::vector<std::size_t>> answer(queries.size());
+            std::size_t min_queries_per_thread = 64;
+            Parallel::parallel_for(0, queries.size(), threads_count, [&](std::size_t l, std::size_t r) {
+                for (std::size_t i = l; i < r; ++i) {
+                    answer[i] = this->nearest(queries[i], k);
+                }
+            }, min_queries_per_thread);
+            return answer;
+        }
+
+        /// <summary>
+        /// in_radius(queries[i], radius) for every i, the queries are split between threads_count threads, 0 means all hardware threads
+        /// </summary>
+        std::vector<std::vector<std::size_t>> in_radius(const std::vector<PointVector<T>>& queries, T radius, std::size_t threads_count) const {
+            std::vector<std::vector<std::size_t>> answer(queries.size());
+            std::size_t min_queries_per_thread = 64;
+            Parallel::parallel_for(0, queries.size(), threads_count, [&](std::size_t l, std::size_t r) {
+                for (std::size_t i = l; i < r; ++i) {
+                    answer[i] = this->in_radius(queries[i], radius);
+                }
+            }, min_queries_per_thread);
+            return answer;
+        }
+    };
+}
@@ -0,0 +1,287 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include "PointVector.hpp"
+
+namespace Geometry {
+    /// <summary>
+    /// The PointCloud class stores points in structure-of-arrays form:
+    /// one contiguous array per coordinate, every array is aligned to alignment bytes.
+    /// Batch kernels work on whole arrays in simple loops the compiler vectorizes,
+    /// and write into caller-provided buffers, so they do not allocate.
+    /// </summary>
+    /// <typeparam name="T">arithmetic type of the coordinates</typeparam>
+    /// <typeparam name="Dimension">count of coordinates of every point</typeparam>
+    template <class T, std::size_t Dimension = 3>
+    class PointCloud {
+        static_assert(std::is_arithmetic_v<T>, "Type T must be arithmetic");
+        static_assert(Dimension > 0, "Dimension must be positive");
+
+    public:
+        using Point = std::array<T, Dimension>;
+        static constexpr std::size_t alignment = 64;
+
+    private:
+        std::size_t count;
+        std::size_t capacity; // in points, a multiple of alignment / sizeof(T)
+        T* data;
+        std::pmr::memory_resource* resource;
+
+        static std::size_t round_capacity(std::size_t capacity) {
+            std::size_t per_line = std::max<std::size_t>(alignment / sizeof(T), 1);
+            return (capacity + per_line - 1) / per_line * per_line;
+        }
+
+        void reallocate(std::size_t new_capacity) {
+            new_capacity = round_capacity(new_capacity);
+            T* new_data = nullptr;
+            if (new_capacity > 0) {
+                new_data = static_cast<T*>(this->resource->allocate(sizeof(T) * new_capacity * Dimension, alignment));
+                for (std::size_t axis = 0; axis < Dimension && this->count > 0; ++axis) {
+                    std::memcpy(new_data + axis * new_capacity, this->coordinate(axis), sizeof(T) * this->count);
+                }
+            }
+            this->deallocate();
+            this->data = new_data;
+            this->capacity = new_capacity;
+        }
+
+        void deallocate() {
+            if (this->data != nullptr) {
+                this->resource->deallocate(this->data, sizeof(T) * this->capacity * Dimension, alignment);
+                this->data = nullptr;
+            }
+        }
+
+    public:
+        PointCloud(std::size_t size = 0, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+            count(0), capacity(0), data(nullptr), resource(resource) {
+            this->resize(size);
+        }
+        PointCloud(const PointCloud& other) : PointCloud(0, other.resource) {
+            *this = other;
+        }
+        PointCloud(PointCloud&& other) noexcept :
+            count(other.count), capacity(other.capacity), data(other.data), resource(other.resource) {
+            other.count = 0;
+            other.capacity = 0;
+            other.data = nullptr;
+        }
+        PointCloud& operator=(const PointCloud& other) {
+            if (this != &other) {
+                this->count = 0;
+                this->reserve(other.count);
+                this->count = other.count;
+                for (std::size_t axis = 0; axis < Dimension && this->count > 0; ++axis) {
+                    std::memcpy(this->coordinate(axis), other.coordinate(axis), sizeof(T) * this->count);
+                }
+            }
+            return *this;
+        }
+        ~PointCloud() {
+            this->deallocate();
+        }
+
+        std::size_t size() const {
+            return this->count;
+        }
+
+        void reserve(std::size_t new_capacity) {
+            if (new_capacity > this->capacity) {
+                this->reallocate(new_capacity);
+            }
+        }
+
+        /// <summary>
+        /// new points are filled with zeros
+        /// </summary>
+        void resize(std::size_t size) {
+            this->reserve(size);
+            for (std::size_t axis = 0; axis < Dimension && size > this->count; ++axis) {
+                std::memset(this->coordinate(axis) + this->count, 0, sizeof(T) * (size - this->count));
+            }
+            this->count = size;
+        }
+
+        void push_back(const Point& point) {
+            if (this->count == this->capacity) {
+                this->reallocate(std::max<std::size_t>(2 * this->capacity, 1));
+            }
+            for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                this->coordinate(axis)[this->count] = point[axis];
+            }
+            ++this->count;
+        }
+
+        void push_back(const PointVector<T>& point) {
+            if (point.size() != Dimension) {
+                throw std::invalid_argument("Dimensions of vectors do not match");
+            }
+            Point coordinates;
+            for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                coordinates[axis] = point[axis];
+            }
+            this->push_back(coordinates);
+        }
+
+        Point get_point(std::size_t index) const {
+            Point point;
+            for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                point[axis] = this->coordinate(axis)[index];
+            }
+            return point;
+        }
+
+        void set_point(std::size_t index, const Point& point) {
+            for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                this->coordinate(axis)[index] = point[axis];
+            }
+        }
+
+        /// <summary>
+        /// contiguous array of the axis-th coordinates of all points
+        /// </summary>
+        T* coordinate(std::size_t axis) {
+            return this->data + axis * this->capacity;
+        }
+
+        const T* coordinate(std::size_t axis) const {
+            return this->data + axis * this->capacity;
+        }
+
+        void translate(const Point& offset) {
+            for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                T* values = this->coordinate(axis);
+                T shift = offset[axis];
+                for (std::size_t i = 0; i < this->count; ++i) {
+                    values[i] += shift;
+                }
+            }
+        }
+
+        void scale(T factor) {
+            for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                T* values = this->coordinate(axis);
+                for (std::size_t i = 0; i < this->count; ++i) {
+                    values[i] *= factor;
+                }
+            }
+        }
+
+        /// <summary>
+        /// out[i] = dotProduct(point i, direction), out must have size() elements
+        /// </summary>
+        void dot_products(const Point& direction, T* out) const {
+            const T* values = this->coordinate(0);
+            for (std::size_t i = 0; i < this->count; ++i) {
+                out[i] = values[i] * direction[0];
+            }
+            for (std::size_t axis = 1; axis < Dimension; ++axis) {
+                values = this->coordinate(axis);
+                T factor = direction[axis];
+                for (std::size_t i = 0; i < this->count; ++i) {
+                    out[i] += values[i] * factor;
+                }
+            }
+        }
+
+        /// <summary>
+        /// out[i] = squared magnitude of point i, out must have size() elements
+        /// </summary>
+        void squared_norms(T* out) const {
+            const T* values = this->coordinate(0);
+            for (std::size_t i = 0; i < this->count; ++i) {
+                out[i] = values[i] * values[i];
+            }
+            for (std::size_t axis = 1; axis < Dimension; ++axis) {
+                values = this->coordinate(axis);
+                for (std::size_t i = 0; i < this->count; ++i) {
+                    out[i] += values[i] * values[i];
+                }
+            }
+        }
+
+        void norms(T* out) const {
+            this->squared_norms(out);
+            for (std::size_t i = 0; i < this->count; ++i) {
+                out[i] = std::sqrt(out[i]);
+            }
+        }
+
+        /// <summary>
+        /// out[i] = distance from point i to point, out must have size() elements
+        /// </summary>
+        void distances_to(const Point& point, T* out) const {
+            for (std::size_t i = 0; i < this->count; ++i) {
+                out[i] = 0;
+            }
+            for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                const T* values = this->coordinate(axis);
+                T center = point[axis];
+                for (std::size_t i = 0; i < this->count; ++i) {
+                    T difference = values[i] - center;
+                    out[i] += difference * difference;
+                }
+            }
+            for (std::size_t i = 0; i < this->count; ++i) {
+                out[i] = std::sqrt(out[i]);
+            }
+        }
+
+        /// <summary>
+        /// out[i * other.size() + j] = distance from point i to point j of other,
+        /// out must have size() * other.size() elements
+        /// </summary>
+        void pairwise_distances(const PointCloud& other, T* out) const {
+            for (std::size_t i = 0; i < this->count; ++i) {
+                T* row = out + i * other.count;
+                for (std::size_t j = 0; j < other.count; ++j) {
+                    row[j] = 0;
+                }
+                for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                    const T* values = other.coordinate(axis);
+                    T center = this->coordinate(axis)[i];
+                    for (std::size_t j = 0; j < other.count; ++j) {
+                        T difference = values[j] - center;
+                        row[j] += difference * difference;
+                    }
+                }
+                for (std::size_t j = 0; j < other.count; ++j) {
+                    row[j] = std::sqrt(row[j]);
+                }
+            }
+        }
+
+        /// <summary>
+        /// divides every point by its magnitude, zero points stay zero
+        /// </summary>
+        void normalize() {
+            for (std::size_t begin = 0; begin < this->count; begin += alignment) {
+                std::size_t length = std::min(alignment, this->count - begin);
+                T magnitudes[alignment];
+                for (std::size_t i = 0; i < length; ++i) {
+                    magnitudes[i] = 0;
+                }
+                for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                    const T* values = this->coordinate(axis) + begin;
+                    for (std::size_t i = 0; i < length; ++i) {
+                        magnitudes[i] += values[i] * values[i];
+                    }
+                }
+                for (std::size_t i = 0; i < length; ++i) {
+                    magnitudes[i] = (magnitudes[i] == 0 ? 1 : std::sqrt(magnitudes[i]));
+                }
+                for (std::size_t axis = 0; axis < Dimension; ++axis) {
+                    T* values = this->coordinate(axis) + begin;
+                    for (std::size_t i = 0; i < length; ++i) {
+                        values[i] /= magnitudes[i];
+                    }
+                }
+            }
+        }
+    };
+}
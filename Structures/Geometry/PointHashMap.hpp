@@ -0,0 +1,384 @@
+#pragma once
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <memory_resource>
+#include "MathPointVector2D.hpp"
+
+namespace Geometry {
+    /// <summary>
+    /// Hash of MathPointVector2DOnInt: both coordinates are packed into 64 bits
+    /// and passed through the splitmix64 finalizer, so every bit of the result depends on every bit of both coordinates.
+    /// Unlike MathPointVector2DOnInt::Hash it does not cluster on grid-aligned points.
+    /// </summary>
+    struct PointMixHash {
+        std::uint64_t operator()(const MathPointVector2DOnInt& p) const {
+            std::uint64_t hash = ((std::uint64_t)(std::uint32_t)p.get_x() << 32) | (std::uint32_t)p.get_y();
+            hash ^= hash >> 30;
+            hash *= 0xbf58476d1ce4e5b9ull;
+            hash ^= hash >> 27;
+            hash *= 0x94d049bb133111ebull;
+            hash ^= hash >> 31;
+            return hash;
+        }
+    };
+
+    /// <summary>
+    /// The PointHashMap class is a flat open-addressing hash map from MathPointVector2DOnInt to Value
+    /// with Robin Hood probing: all entries live in one array, there is no allocation per entry.
+    /// </summary>
+    /// <typeparam name="Value">must be default constructible</typeparam>
+    /// <remarks>
+    /// An entry that is farther from its home slot takes the slot of an entry that is closer to its own,
+    /// so probe lengths stay short and a lookup stops as soon as it meets an entry closer to home than the key would be.
+    /// Erasing shifts the following entries back instead of leaving tombstones.
+    /// Asymptotics:
+    /// - find, insert, erase: O(1) expected, the load factor is kept at most 7/8.
+    /// </remarks>
+    template <class Value>
+    class PointHashMap {
+    private:
+        struct Slot {
+            MathPointVector2DOnInt key;
+            Value value;
+            std::uint32_t distance = 0; // 0 means the slot is empty, otherwise distance from the home slot + 1
+        };
+
+        std::pmr::vector<Slot> slots;
+        std::size_t count;
+        std::size_t mask;
+
+        std::size_t get_home(const MathPointVector2DOnInt& key) const {
+            return PointMixHash{}(key) & this->mask;
+        }
+
+        std::size_t find_slot(const MathPointVector2DOnInt& key) const {
+            if (this->slots.empty()) {
+                return this->slots.size();
+            }
+            std::size_t slot = this->get_home(key);
+            for (std::uint32_t distance = 1; distance <= this->slots[slot].distance; ++distance) {
+                if (this->slots[slot].key == key) {
+                    return slot;
+                }
+                slot = (slot + 1) & this->mask;
+            }
+            return this->slots.size();
+        }
+
+        void rehash(std::size_t capacity) {
+            std::pmr::vector<Slot> old_slots(capacity, this->slots.get_allocator().resource());
+            std::swap(old_slots, this->slots);
+            this->mask = capacity - 1;
+            this->count = 0;
+            for (auto& slot : old_slots) {
+                if (slot.distance != 0) {
+                    this->insert_new(std::move(slot.key), std::move(slot.value));
+                }
+            }
+        }
+
+        /// <summary>
+        /// key must be absent, returns the slot where the new entry ended up
+        /// </summary>
+        std::size_t insert_new(MathPointVector2DOnInt key, Value value) {
+            if (8 * (this->count + 1) > 7 * this->slots.size()) {
+                this->rehash(std::max<std::size_t>(2 * this->slots.size(), 16));
+            }
+            std::size_t slot = this->get_home(key);
+            std::size_t result = this->slots.size();
+            std::uint32_t distance = 1;
+            while (true) {
+                auto& current = this->slots[slot];
+                if (current.distance == 0) {
+                    current.key = std::move(key);
+                    current.value = std::move(value);
+                    current.distance = distance;
+                    ++this->count;
+                    return result == this->slots.size() ? slot : result;
+                }
+                if (current.distance < distance) {
+                    std::swap(current.key, key);
+                    std::swap(current.value, value);
+                    std::swap(current.distance, distance);
+                    if (result == this->slots.size()) {
+                        result = slot;
+                    }
+                }
+                slot = (slot + 1) & this->mask;
+                ++distance;
+            }
+        }
+
+    public:
+        PointHashMap(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : slots(resource), count(0), mask(0) {}
+
+        std::size_t size() const {
+            return this->count;
+        }
+
+        bool empty() const {
+            return this->count == 0;
+        }
+
+        void clear() {
+            for (auto& slot : this->slots) {
+                slot = Slot();
+            }
+            this->count = 0;
+        }
+
+        /// <summary>
+        /// makes room for count entries without rehashing
+        /// </summary>
+        void reserve(std::size_t count) {
+            std::size_t capacity = 16;
+            while (7 * capacity < 8 * count) {
+                capacity *= 2;
+            }
+            if (capacity > this->slots.size()) {
+                this->rehash(capacity);
+            }
+        }
+
+        Value* find(const MathPointVector2DOnInt& key) {
+            std::size_t slot = this->find_slot(key);
+            return slot == this->slots.size() ? nullptr : &this->slots[slot].value;
+        }
+
+        const Value* find(const MathPointVector2DOnInt& key) const {
+            std::size_t slot = this->find_slot(key);
+            return slot == this->slots.size() ? nullptr : &this->slots[slot].value;
+        }
+
+        bool contains(const MathPointVector2DOnInt& key) const {
+            return this->find_slot(key) != this->slots.size();
+        }
+
+        /// <summary>
+        /// returns false and keeps the old value if key is already present
+        /// </summary>
+        bool insert(const MathPointVector2DOnInt& key, const Value& value) {
+            if (this->contains(key)) {
+                return false;
+            }
+            this->insert_new(key, value);
+            return true;
+        }
+
+        Value& operator[](const MathPointVector2DOnInt& key) {
+            std::size_t slot = this->find_slot(key);
+            if (slot == this->slots.size()) {
+                slot = this->insert_new(key, Value());
+            }
+            return this->slots[slot].value;
+        }
+
+        bool erase(const MathPointVector2DOnInt& key) {
+            std::size_t slot = this->find_slot(key);
+            if (slot == this->slots.size()) {
+                return false;
+            }
+            std::size_t next = (slot + 1) & this->mask;
+            while (this->slots[next].distance > 1) {
+                this->slots[slot] = std::move(this->slots[next]);
+                --this->slots[slot].distance;
+                slot = next;
+                next = (next + 1) & this->mask;
+            }
+            this->slots[slot] = Slot();
+            --this->count;
+            return true;
+        }
+
+        /// <summary>
+        /// calls func(key, value) for every entry in no particular order
+        /// </summary>
+        template <class Function>
+        void for_each(Function&& func) const {
+            for (const auto& slot : this->slots) {
+                if (slot.distance != 0) {
+                    func(slot.key, slot.value);
+                }
+            }
+        }
+
+        template <class Function>
+        void for_each(Function&& func) {
+            for (auto& slot : this->slots) {
+                if (slot.distance != 0) {
+                    func(static_cast<const MathPointVector2DOnInt&>(slot.key), slot.value);
+                }
+            }
+        }
+    };
+
+    /// <summary>
+    /// The PointHashSet class is a flat open-addressing hash set of MathPointVector2DOnInt, see PointHashMap.
+    /// </summary>
+    class PointHashSet {
+    private:
+        PointHashMap<bool> map;
+
+    public:
+        PointHashSet(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : map(resource) {}
+
+        std::size_t size() const {
+            return this->map.size();
+        }
+
+        bool empty() const {
+            return this->map.empty();
+        }
+
+        void clear() {
+            this->map.clear();
+        }
+
+        void reserve(std::size_t count) {
+            this->map.reserve(count);
+        }
+
+        bool contains(const MathPointVector2DOnInt& key) const {
+            return this->map.contains(key);
+        }
+
+        bool insert(const MathPointVector2DOnInt& key) {
+            return this->map.insert(key, true);
+        }
+
+        bool erase(const MathPointVector2DOnInt& key) {
+            return this->map.erase(key);
+        }
+
+        template <class Function>
+        void for_each(Function&& func) const {
+            this->map.for_each([&](const MathPointVector2DOnInt& key, bool) {
+                func(key);
+            });
+        }
+    };
+
+    /// <summary>
+    /// The UniformGrid class is a spatial index over integer points:
+    /// the plane is split into square cells of side cell_size, points of one cell are stored contiguously,
+    /// and a PointHashMap maps a non-empty cell to its range of points.
+    /// </summary>
+    /// <remarks>
+    /// Asymptotics:
+    /// - Building the data structure: O(N) expected.
+    /// - Points of a cell: O(1) expected plus the size of the answer.
+    /// - Points near a point (the 3 x 3 block of cells around it): O(1) expected plus the count of visited points.
+    /// </remarks>
+    class UniformGrid {
+    private:
+        int cell_size;
+        std::pmr::vector<MathPointVector2DOnInt> points; // sorted by cell
+        std::pmr::vector<std::size_t> indices; // index of points[i] in the input
+        PointHashMap<std::pair<std::size_t, std::size_t>> cells; // [begin, end) in points
+
+        static int floor_divide(int a, int b) {
+            int quotient = a / b;
+            return (a % b != 0 && (a < 0) != (b < 0)) ? quotient - 1 : quotient;
+        }
+
+        std::pair<std::size_t, std::size_t> get_range(const MathPointVector2DOnInt& cell) const {
+            auto range = this->cells.find(cell);
+            return range == nullptr ? std::pair<std::size_t, std::size_t>(0, 0) : *range;
+        }
+
+    public:
+        /// <param name="points">indexed points, queries return indices in this vector</param>
+        /// <param name="cell_size">side of a cell, must be positive</param>
+        /// <param name="resource">memory resource for the grid</param>
+        UniformGrid(const std::vector<MathPointVector2DOnInt>& points, int cell_size, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+            cell_size(cell_size), points(points.size(), resource), indices(points.size(), resource), cells(resource) {
+            this->cells.reserve(points.size());
+            for (const auto& point : points) {
+                ++this->cells[this->get_cell(point)].second;
+            }
+            std::size_t begin = 0;
+            this->cells.for_each([&](const MathPointVector2DOnInt&, std::pair<std::size_t, std::size_t>& range) {
+                range.first = begin;
+                begin += range.second;
+                range.second = range.first;
+            });
+            for (std::size_t i = 0; i < points.size(); ++i) {
+                std::size_t& end = this->cells.find(this->get_cell(points[i]))->second;
+                this->points[end] = points[i];
+                this->indices[end] = i;
+                ++end;
+            }
+        }
+
+        std::size_t size() const {
+            return this->points.size();
+        }
+
+        int get_cell_size() const {
+            return this->cell_size;
+        }
+
+        MathPointVector2DOnInt get_cell(const MathPointVector2DOnInt& point) const {
+            return { floor_divide(point.get_x(), this->cell_size), floor_divide(point.get_y(), this->cell_size) };
+        }
+
+        /// <summary>
+        /// points of the cell, in no particular order
+        /// </summary>
+        std::span<const MathPointVector2DOnInt> get_points_in_cell(const MathPointVector2DOnInt& cell) const {
+            auto [begin, end] = this->get_range(cell);
+            return { this->points.data() + begin, end - begin };
+        }
+
+        /// <summary>
+        /// indices of the points of the cell, in the order of get_points_in_cell
+        /// </summary>
+        std::span<const std::size_t> get_indices_in_cell(const MathPointVector2DOnInt& cell) const {
+            auto [begin, end] = this->get_range(cell);
+            return { this->indices.data() + begin, end - begin };
+        }
+
+        /// <summary>
+        /// calls func(index, point) for every point in the cell of point and in the 8 neighbouring cells,
+        /// so every point closer than cell_size to point is visited
+        /// </summary>
+        template <class Function>
+        void for_each_near(const MathPointVector2DOnInt& point, Function&& func) const {
+            auto cell = this->get_cell(point);
+            for (int dx = -1; dx <= 1; ++dx) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    auto [begin, end] = this->get_range(cell + MathPointVector2DOnInt(dx, dy));
+                    for (std::size_t i = begin; i < end; ++i) {
+                        func(this->indices[i], this->points[i]);
+                    }
+                }
+            }
+        }
+
+        /// <summary>
+        /// indices of all points at distance at most radius from point, in no particular order
+        /// </summary>
+        std::vector<std::size_t> in_radius(const MathPointVector2DOnInt& point, int radius) const {
+            std::vector<std::size_t> answer;
+            auto low = this->get_cell(point - MathPointVector2DOnInt(radius, radius));
+            auto high = this->get_cell(point + MathPointVector2DOnInt(radius, radius));
+            long long squared_radius = (long long)radius * radius;
+            for (int x = low.get_x(); x <= high.get_x(); ++x) {
+                for (int y = low.get_y(); y <= high.get_y(); ++y) {
+                    auto [begin, end] = this->get_range({ x, y });
+                    for (std::size_t i = begin; i < end; ++i) {
+                        long long dx = (long long)this->points[i].get_x() - point.get_x();
+                        long long dy = (long long)this->points[i].get_y() - point.get_y();
+                        if (dx * dx + dy * dy <= squared_radius) {
+                            answer.push_back(this->indices[i]);
+                        }
+                    }
+                }
+            }
+            return answer;
+        }
+    };
+}
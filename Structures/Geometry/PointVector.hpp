@@ -4,8 +4,13 @@
 #include <cmath>
 #include <string>
 #include <cassert>
+#include <span>
 
-template <class T>
+/// <summary>
+/// PointVector&lt;T&gt; has the dimension chosen at runtime,
+/// PointVector&lt;T, N&gt; with a fixed N is declared in FixedPointVector.hpp
+/// </summary>
+template <class T, std::size_t Dimension = std::dynamic_extent>
 class PointVector {
 private:
     std::vector<T> coordinates;
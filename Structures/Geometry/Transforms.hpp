@@ -0,0 +1,229 @@
+#pragma once
+#include <span>
+#include <array>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include "PointCloud.hpp"
+#include "FixedPointVector.hpp"
+#include "../Parallel.hpp"
+
+namespace Geometry {
+    /// <summary>
+    /// Rotation of the plane by a fixed angle, cos and sin are computed once in the constructor.
+    /// </summary>
+    template <class T>
+    class Rotation2D {
+        static_assert(std::is_floating_point_v<T>, "Type T must be floating point");
+
+    private:
+        T cos_, sin_;
+
+    public:
+        Rotation2D(T angle) : cos_(std::cos(angle)), sin_(std::sin(angle)) {}
+
+        T get_cos() const {
+            return this->cos_;
+        }
+
+        T get_sin() const {
+            return this->sin_;
+        }
+
+        std::array<std::array<T, 2>, 2> get_matrix() const {
+            return { { { this->cos_, -this->sin_ }, { this->sin_, this->cos_ } } };
+        }
+    };
+
+    /// <summary>
+    /// Unit quaternion describing a rotation of the space.
+    /// Composition costs 16 multiplications and never calls trigonometric functions.
+    /// </summary>
+    template <class T>
+    class Quaternion {
+        static_assert(std::is_floating_point_v<T>, "Type T must be floating point");
+
+    private:
+        T w, x, y, z;
+
+    public:
+        Quaternion(T w = 1, T x = 0, T y = 0, T z = 0) : w(w), x(x), y(y), z(z) {}
+
+        /// <summary>
+        /// rotation by angle counterclockwise around axis (looking from its end), axis must be non-zero
+        /// </summary>
+        static Quaternion from_axis_angle(const std::array<T, 3>& axis, T angle) {
+            T length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+            T factor = std::sin(angle / 2) / length;
+            return Quaternion(std::cos(angle / 2), axis[0] * factor, axis[1] * factor, axis[2] * factor);
+        }
+
+        /// <summary>
+        /// rotation by other first and by this after it
+        /// </summary>
+        Quaternion operator*(const Quaternion& other) const {
+            return Quaternion(
+                this->w * other.w - this->x * other.x - this->y * other.y - this->z * other.z,
+                this->w * other.x + this->x * other.w + this->y * other.z - this->z * other.y,
+                this->w * other.y - this->x * other.z + this->y * other.w + this->z * other.x,
+                this->w * other.z + this->x * other.y - this->y * other.x + this->z * other.w
+            );
+        }
+
+        Quaternion conjugate() const {
+            return Quaternion(this->w, -this->x, -this->y, -this->z);
+        }
+
+        Quaternion normalize() const {
+            T length = std::sqrt(this->w * this->w + this->x * this->x + this->y * this->y + this->z * this->z);
+            return Quaternion(this->w / length, this->x / length, this->y / length, this->z / length);
+        }
+
+        std::array<std::array<T, 3>, 3> get_matrix() const {
+            T xx = this->x * this->x, yy = this->y * this->y, zz = this->z * this->z;
+            T xy = this->x * this->y, xz = this->x * this->z, yz = this->y * this->z;
+            T wx = this->w * this->x, wy = this->w * this->y, wz = this->w * this->z;
+            return { {
+                { 1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy) },
+                { 2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx) },
+                { 2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy) }
+            } };
+        }
+    };
+
+    /// <summary>
+    /// The AffineTransform class is the map p -> matrix * p + translation.
+    /// Rotations are turned into matrices once, applying the transform to a point
+    /// costs Dimension * Dimension multiply-adds and no trigonometric calls.
+    /// </summary>
+    template <class T, std::size_t Dimension>
+    class AffineTransform {
+    public:
+        using Matrix = std::array<std::array<T, Dimension>, Dimension>;
+        using Vector = std::array<T, Dimension>;
+
+    private:
+        Matrix matrix;
+        Vector translation;
+
+    public:
+        /// <summary>
+        /// identity
+        /// </summary>
+        AffineTransform() : matrix{}, translation{} {
+            for (std::size_t i = 0; i < Dimension; ++i) {
+                this->matrix[i][i] = 1;
+            }
+        }
+
+        AffineTransform(const Matrix& matrix, const Vector& translation = {}) : matrix(matrix), translation(translation) {}
+
+        AffineTransform(const Rotation2D<T>& rotation, const Vector& translation = {}) requires (Dimension == 2) :
+            matrix(rotation.get_matrix()), translation(translation) {}
+
+        AffineTransform(const Quaternion<T>& rotation, const Vector& translation = {}) requires (Dimension == 3) :
+            matrix(rotation.normalize().get_matrix()), translation(translation) {}
+
+        static AffineTransform scaling(T factor) {
+            AffineTransform transform;
+            for (std::size_t i = 0; i < Dimension; ++i) {
+                transform.matrix[i][i] = factor;
+            }
+            return transform;
+        }
+
+        static AffineTransform translating(const Vector& translation) {
+            AffineTransform transform;
+            transform.translation = translation;
+            return transform;
+        }
+
+        const Matrix& get_matrix() const {
+            return this->matrix;
+        }
+
+        const Vector& get_translation() const {
+            return this->translation;
+        }
+
+        /// <summary>
+        /// other first and this after it
+        /// </summary>
+        AffineTransform operator*(const AffineTransform& other) const {
+            AffineTransform result(Matrix{}, this->apply(other.translation));
+            for (std::size_t i = 0; i < Dimension; ++i) {
+                for (std::size_t j = 0; j < Dimension; ++j) {
+                    for (std::size_t k = 0; k < Dimension; ++k) {
+                        result.matrix[i][j] += this->matrix[i][k] * other.matrix[k][j];
+                    }
+                }
+            }
+            return result;
+        }
+
+        Vector apply(const Vector& point) const {
+            Vector result = this->translation;
+            for (std::size_t i = 0; i < Dimension; ++i) {
+                for (std::size_t j = 0; j < Dimension; ++j) {
+                    result[i] += this->matrix[i][j] * point[j];
+                }
+            }
+            return result;
+        }
+
+        PointVector<T, Dimension> apply(const PointVector<T, Dimension>& point) const {
+            return PointVector<T, Dimension>(this->apply(point.getCoordinates()));
+        }
+    };
+
+    /// <summary>
+    /// applies transform to every point of cloud in place
+    /// </summary>
+    /// <param name="threads_count">the cloud is split into ranges of points between threads, 0 means all hardware threads</param>
+    /// <remarks>
+    /// Points are processed in blocks of PointCloud::alignment: the new coordinates of a block are accumulated
+    /// axis by axis in small arrays and written back, so every inner loop runs over contiguous coordinates and vectorizes.
+    /// </remarks>
+    template <class T, std::size_t Dimension>
+    void transform(PointCloud<T, Dimension>& cloud, const AffineTransform<T, Dimension>& transform, std::size_t threads_count = 1) {
+        constexpr std::size_t block_length = PointCloud<T, Dimension>::alignment;
+        const auto& matrix = transform.get_matrix();
+        const auto& translation = transform.get_translation();
+        std::size_t blocks_count = (cloud.size() + block_length - 1) / block_length;
+        Parallel::parallel_for(0, blocks_count, threads_count, [&](std::size_t first_block, std::size_t last_block) {
+            T result[Dimension][block_length];
+            for (std::size_t block = first_block; block < last_block; ++block) {
+                std::size_t begin = block * block_length;
+                std::size_t length = std::min(block_length, cloud.size() - begin);
+                for (std::size_t i = 0; i < Dimension; ++i) {
+                    for (std::size_t p = 0; p < length; ++p) {
+                        result[i][p] = translation[i];
+                    }
+                    for (std::size_t j = 0; j < Dimension; ++j) {
+                        const T* values = cloud.coordinate(j) + begin;
+                        T factor = matrix[i][j];
+                        for (std::size_t p = 0; p < length; ++p) {
+                            result[i][p] += factor * values[p];
+                        }
+                    }
+                }
+                for (std::size_t i = 0; i < Dimension; ++i) {
+                    std::copy(result[i], result[i] + length, cloud.coordinate(i) + begin);
+                }
+            }
+        }, 256);
+    }
+
+    /// <summary>
+    /// applies transform to every point of points in place
+    /// </summary>
+    /// <param name="threads_count">points are split into ranges between threads, 0 means all hardware threads</param>
+    template <class T, std::size_t Dimension>
+    void transform(std::span<PointVector<T, Dimension>> points, const AffineTransform<T, Dimension>& transform, std::size_t threads_count = 1) {
+        Parallel::parallel_for(0, points.size(), threads_count, [&](std::size_t l, std::size_t r) {
+            for (std::size_t p = l; p < r; ++p) {
+                points[p] = transform.apply(points[p]);
+            }
+        }, 1 << 14);
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <bit>
+#include <algorithm>
+
+namespace Instrumentation {
+	static const size_t count_of_latency_buckets = 64;
+
+	/// <summary>
+	/// values of the counters of a structure at the moment of the call of its get_statistics
+	/// </summary>
+	struct Snapshot {
+		size_t builds = 0;
+		size_t queries = 0;
+		size_t updates = 0;
+		size_t touched = 0; // nodes, blocks, levels or sieve cells touched by builds, queries and updates
+		size_t memory_bytes = 0;
+		/// <summary>
+		/// latency_histogram[i] is the count of sampled queries and updates that took [2^i, 2^(i + 1)) nanoseconds
+		/// </summary>
+		std::array<size_t, count_of_latency_buckets> latency_histogram = {};
+	};
+
+	/// <summary>
+	/// The NoStatistics policy is the default one: it has no state and all its methods are empty,
+	/// so the instrumented structures compile to the same code as without instrumentation.
+	/// </summary>
+	class NoStatistics {
+	public:
+		class Scope {
+		public:
+			~Scope() {} // user-provided, so that unused scopes do not raise warnings
+		};
+
+		static constexpr bool enabled = false;
+
+		void touch(size_t = 1) const {}
+
+		Scope start_build() const {
+			return {};
+		}
+
+		Scope start_query() const {
+			return {};
+		}
+
+		Scope start_update() const {
+			return {};
+		}
+
+		Snapshot get_snapshot() const {
+			return {};
+		}
+	};
+
+	/// <summary>
+	/// The CollectStatistics policy counts builds, queries, updates and touched elements,
+	/// and samples the latency of every sampling_period-th query or update into a histogram.
+	/// The counters are atomic, so const queries can be called from many threads.
+	/// </summary>
+	template <size_t sampling_period = 1>
+	class CollectStatistics {
+	private:
+		using Counter = std::atomic<size_t>;
+		using Clock = std::chrono::steady_clock;
+
+		Counter builds, queries, updates, touched;
+		std::array<Counter, count_of_latency_buckets> latency_histogram;
+
+		void add(Counter& counter, size_t count = 1) {
+			counter.fetch_add(count, std::memory_order_relaxed);
+		}
+
+		void add_latency(Clock::time_point start) {
+			auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+			size_t bucket = std::bit_width((size_t)std::max<long long>(nanoseconds, 1)) - 1;
+			this->add(this->latency_histogram[bucket]);
+		}
+
+	public:
+		class Scope {
+		private:
+			CollectStatistics* statistics;
+			bool sampled;
+			Clock::time_point start;
+
+		public:
+			Scope(CollectStatistics* statistics, bool sampled) :
+				statistics(statistics), sampled(sampled), start(sampled ? Clock::now() : Clock::time_point()) {}
+			Scope(const Scope&) = delete;
+
+			~Scope() {
+				if (this->sampled) {
+					this->statistics->add_latency(this->start);
+				}
+			}
+		};
+
+		static constexpr bool enabled = true;
+
+		CollectStatistics() : builds(0), queries(0), updates(0), touched(0), latency_histogram() {}
+		CollectStatistics(const CollectStatistics& other) : CollectStatistics() {
+			*this = other;
+		}
+		CollectStatistics& operator=(const CollectStatistics& other) {
+			auto snapshot = other.get_snapshot();
+			this->builds = snapshot.builds;
+			this->queries = snapshot.queries;
+			this->updates = snapshot.updates;
+			this->touched = snapshot.touched;
+			for (size_t i = 0; i < count_of_latency_buckets; ++i) {
+				this->latency_histogram[i] = snapshot.latency_histogram[i];
+			}
+			return *this;
+		}
+
+		void touch(size_t count = 1) {
+			this->add(this->touched, count);
+		}
+
+		Scope start_build() {
+			this->add(this->builds);
+			return Scope(this, false);
+		}
+
+		Scope start_query() {
+			auto number = this->queries.fetch_add(1, std::memory_order_relaxed);
+			return Scope(this, number % sampling_period == 0);
+		}
+
+		Scope start_update() {
+			auto number = this->updates.fetch_add(1, std::memory_order_relaxed);
+			return Scope(this, number % sampling_period == 0);
+		}
+
+		Snapshot get_snapshot() const {
+			Snapshot snapshot;
+			snapshot.builds = this->builds.load(std::memory_order_relaxed);
+			snapshot.queries = this->queries.load(std::memory_order_relaxed);
+			snapshot.updates = this->updates.load(std::memory_order_relaxed);
+			snapshot.touched = this->touched.load(std::memory_order_relaxed);
+			for (size_t i = 0; i < count_of_latency_buckets; ++i) {
+				snapshot.latency_histogram[i] = this->latency_histogram[i].load(std::memory_order_relaxed);
+			}
+			return snapshot;
+		}
+	};
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include <string>
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/// <summary>
+/// The MappedBitArray class is a BitArray stored in a file and memory-mapped (POSIX mmap),
+/// so it may be larger than RAM: pages are read from the file on first access and evicted by the kernel under memory pressure.
+/// Indices are size_t, unlike BitArray.
+/// </summary>
+/// <remarks>
+/// File layout: a header (magic number and size in bits) followed by 64-bit words, bit i is bit i % 64 of word i / 64.
+/// </remarks>
+class MappedBitArray {
+public:
+	enum class Mode {
+		create, // creates or truncates the file, all bits are false
+		read_only,
+		read_write
+	};
+
+	enum class Access {
+		normal, sequential, random, will_need, dont_need
+	};
+
+private:
+	struct Header {
+		std::uint64_t magic;
+		std::uint64_t size;
+	};
+
+	static constexpr std::uint64_t magic_number = 0x5942524141544942ull; // "BITAARBY"
+
+	size_t _size;
+	int file;
+	size_t length; // of the mapping in bytes
+	void* mapping;
+	std::uint64_t* words;
+
+	static std::system_error make_error(const std::string& what) {
+		return std::system_error(errno, std::generic_category(), what);
+	}
+
+	static size_t get_length(size_t size) {
+		return sizeof(Header) + (size + 63) / 64 * sizeof(std::uint64_t);
+	}
+
+	void close() {
+		if (this->mapping != nullptr) {
+			munmap(this->mapping, this->length);
+			this->mapping = nullptr;
+			this->words = nullptr;
+		}
+		if (this->file != -1) {
+			::close(this->file);
+			this->file = -1;
+		}
+	}
+
+public:
+	/// <param name="path">file of the array</param>
+	/// <param name="mode">how to open the file</param>
+	/// <param name="size">count of bits for Mode::create, ignored otherwise (the size is read from the file)</param>
+	MappedBitArray(const std::string& path, Mode mode, size_t size = 0) :
+		_size(size), file(-1), length(0), mapping(nullptr), words(nullptr) {
+		int flags = mode == Mode::create ? O_RDWR | O_CREAT | O_TRUNC : (mode == Mode::read_only ? O_RDONLY : O_RDWR);
+		this->file = ::open(path.c_str(), flags, 0644);
+		if (this->file == -1) {
+			throw make_error("Cannot open " + path);
+		}
+		Header header = { magic_number, size };
+		if (mode == Mode::create) {
+			if (ftruncate(this->file, get_length(size)) != 0 || pwrite(this->file, &header, sizeof(header), 0) != sizeof(header)) {
+				auto error = make_error("Cannot create " + path);
+				this->close();
+				throw error;
+			}
+		}
+		else if (pread(this->file, &header, sizeof(header), 0) != sizeof(header) || header.magic != magic_number) {
+			this->close();
+			throw std::system_error(std::make_error_code(std::errc::invalid_argument), path + " is not a MappedBitArray");
+		}
+		this->_size = header.size;
+		this->length = get_length(this->_size);
+		struct stat file_status;
+		if (fstat(this->file, &file_status) != 0) {
+			auto error = make_error("Cannot stat " + path);
+			this->close();
+			throw error;
+		}
+		if ((size_t)file_status.st_size < this->length) {
+			this->close();
+			throw std::system_error(std::make_error_code(std::errc::invalid_argument), path + " is truncated");
+		}
+		int protection = mode == Mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+		this->mapping = mmap(nullptr, this->length, protection, MAP_SHARED, this->file, 0);
+		if (this->mapping == MAP_FAILED) {
+			this->mapping = nullptr;
+			auto error = make_error("Cannot map " + path);
+			this->close();
+			throw error;
+		}
+		this->words = reinterpret_cast<std::uint64_t*>(static_cast<char*>(this->mapping) + sizeof(Header));
+	}
+
+	MappedBitArray(const MappedBitArray&) = delete;
+	MappedBitArray& operator=(const MappedBitArray&) = delete;
+
+	MappedBitArray(MappedBitArray&& other) noexcept :
+		_size(other._size), file(other.file), length(other.length), mapping(other.mapping), words(other.words) {
+		other.file = -1;
+		other.mapping = nullptr;
+		other.words = nullptr;
+	}
+
+	MappedBitArray& operator=(MappedBitArray&& other) noexcept {
+		if (this != &other) {
+			this->close();
+			std::swap(this->_size, other._size);
+			std::swap(this->file, other.file);
+			std::swap(this->length, other.length);
+			std::swap(this->mapping, other.mapping);
+			std::swap(this->words, other.words);
+		}
+		return *this;
+	}
+
+	~MappedBitArray() {
+		this->close();
+	}
+
+	size_t size() const {
+		return this->_size;
+	}
+
+	size_t get_count_of_words() const {
+		return (this->_size + 63) / 64;
+	}
+
+	/// <summary>
+	/// direct access to the words, for bulk filling
+	/// </summary>
+	std::uint64_t* get_words() {
+		return this->words;
+	}
+
+	const std::uint64_t* get_words() const {
+		return this->words;
+	}
+
+	bool operator[](size_t index) const {
+		return (this->words[index >> 6] >> (index & 63)) & 1;
+	}
+
+	void set_true(size_t index) {
+		this->words[index >> 6] |= (std::uint64_t)1 << (index & 63);
+	}
+
+	void set_false(size_t index) {
+		this->words[index >> 6] &= ~((std::uint64_t)1 << (index & 63));
+	}
+
+	/// <summary>
+	/// madvise hint for the pages holding the bits [begin, end)
+	/// </summary>
+	void advise(Access access, size_t begin = 0, size_t end = SIZE_MAX) {
+		static const int advices[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED, MADV_DONTNEED };
+		size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+		end = std::min(end, this->_size);
+		if (begin >= end) {
+			return;
+		}
+		size_t first_byte = sizeof(Header) + begin / 64 * sizeof(std::uint64_t);
+		size_t last_byte = sizeof(Header) + (end + 63) / 64 * sizeof(std::uint64_t);
+		first_byte = first_byte / page_size * page_size;
+		madvise(static_cast<char*>(this->mapping) + first_byte, last_byte - first_byte, advices[(int)access]);
+	}
+
+	/// <summary>
+	/// writes the changed pages to the file and waits for it
+	/// </summary>
+	void flush() {
+		if (msync(this->mapping, this->length, MS_SYNC) != 0) {
+			throw make_error("Cannot flush a MappedBitArray");
+		}
+	}
+};
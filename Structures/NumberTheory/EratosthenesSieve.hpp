@@ -5,18 +5,27 @@
 #include <iostream>
 #include <utility>
 #include "../BitArray.hpp"
+#include "../Instrumentation.hpp"
+#include "PrimeOracle.hpp" // get_Goldbach_expansion and make_sure_that_Bertrand_postulate_is_correct
 
 namespace NumberTheory {
-	class EratosthenesSieve {
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
+	template <class Statistics = Instrumentation::NoStatistics>
+	class BasicEratosthenesSieve {
 	private:
 		size_t n;
 		size_t count_of_primes;
 		BitArray prime;
+		[[no_unique_address]] mutable Statistics statistics;
 
 	public:
-		EratosthenesSieve(size_t n) : n(n), prime(n, true), count_of_primes(0) {}
+		/// <param name="resource">memory resource for the bitmap</param>
+		BasicEratosthenesSieve(size_t n, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			n(n), prime(n, true, resource), count_of_primes(0) {}
 
 		void build() {
+			auto scope = this->statistics.start_build();
+			size_t crossed_out = 0;
 			prime.set_false(0);
 			prime.set_false(1);
 			for (size_t i = 2; i * i < n; ++i) {
@@ -24,9 +33,11 @@ namespace NumberTheory {
 					++count_of_primes;
 					for (size_t j = i * i; j < n; j += i) {
 						prime.set_false(j);
+						++crossed_out;
 					}
 				}
 			}
+			this->statistics.touch(crossed_out);
 		}
 
 		BitArray get_sieve_in_bitarray() const {
@@ -34,6 +45,7 @@ namespace NumberTheory {
 		}
 
 		inline bool is_prime(size_t num) const {
+			auto scope = this->statistics.start_query();
 			return prime[num];
 		}
 
@@ -47,7 +59,7 @@ namespace NumberTheory {
 
 		void go_through_prime_numbers(const std::function<void(const size_t&)>& process_prime) const {
 			for (size_t i = 2; i < this->get_length(); ++i) {
-				if (this->is_prime(i)) {
+				if (this->prime[i]) {
 					process_prime(i);
 				}
 			}
@@ -65,7 +77,7 @@ namespace NumberTheory {
 			const std::function<void(const size_t&)>& process_prime,
 			const std::function<void(const size_t&, const size_t&)>& get_prime_and_multiple) const {
 			for (size_t i = 2; i < this->get_length(); ++i) {
-				if (this->is_prime(i)) {
+				if (this->prime[i]) {
 					process_prime(i);
 					for (int j = i * i; j < this->get_length(); j += i) {
 						get_prime_and_multiple(i, j);
@@ -92,45 +104,17 @@ namespace NumberTheory {
 			}
 			return true;
 		}
-	};
-
-	std::pair<size_t, size_t> get_Goldbach_expansion(size_t n) {
-		NumberTheory::EratosthenesSieve prime(n + 1);
-		prime.build();
 
-		for (size_t i = 2; i <= n; ++i) {
-			if (!prime.is_prime(i)) {
-				continue;
-			}
-			size_t j = n - i;
-			if (!prime.is_prime(j)) {
-				continue;
-			}
-			return { i, j };
+		size_t memory_bytes() const {
+			return sizeof(*this) + this->prime.get_count_of_containers() * sizeof(container);
 		}
-		return { 0, 0 };
-	}
 
-	std::vector<size_t> make_sure_that_Bertrand_postulate_is_correct(size_t n, bool search_all = false) {
-		NumberTheory::EratosthenesSieve prime(2 * n + 1);
-		prime.build();
-		std::vector<size_t> primes;
-		size_t j = n + 1;
-		for (; j < 2 * n; ++j) {
-			if (prime.is_prime(j)) {
-				primes.push_back(j);
-				if (!search_all) {
-					return primes;
-				}
-				break;
-			}
-		}
-		++j;
-		for (; j < 2 * n; ++j) {
-			if (prime.is_prime(j)) {
-				primes.push_back(j);
-			}
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
 		}
-		return primes;
-	}
+	};
+
+	using EratosthenesSieve = BasicEratosthenesSieve<>;
 }
@@ -2,13 +2,16 @@
 #include "EratosthenesSieve.hpp"
 
 namespace NumberTheory {
-	class Factorizer {
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
+	template <class Statistics = Instrumentation::NoStatistics>
+	class BasicFactorizer {
 	private:
 		size_t n;
-		std::vector<size_t> minimal_prime_divisors;
+		std::pmr::vector<size_t> minimal_prime_divisors;
+		[[no_unique_address]] Statistics statistics;
 
 	public:
-		Factorizer() : n(0), minimal_prime_divisors() {}
+		BasicFactorizer(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : n(0), minimal_prime_divisors(resource) {}
 
 		inline size_t get_size() const {
 			return this->n;
@@ -19,13 +22,14 @@ namespace NumberTheory {
 		}
 
 		void build(size_t n) {
+			auto scope = this->statistics.start_build();
 			size_t recommended_max_size = (size_t)1e6;
 			this->n = n;
 			if (this->n > recommended_max_size) {
 				this->n = recommended_max_size;
 			}
 			minimal_prime_divisors.assign(this->n, -1);
-			NumberTheory::EratosthenesSieve sieve(this->get_size());
+			NumberTheory::EratosthenesSieve sieve(this->get_size(), this->minimal_prime_divisors.get_allocator().resource());
 			sieve.build();
 			sieve.go_through_prime_numbers_with_their_multiples(
 				[this](size_t i) { this->_process_prime(i); },
@@ -38,14 +42,43 @@ namespace NumberTheory {
 		}
 
 		std::vector<size_t> factorize(size_t n, bool repetitions = true) {
+			std::vector<size_t> prime_factors;
+			this->factorize_into(prime_factors, n, repetitions);
+			return prime_factors;
+		}
+
+		/// <summary>
+		/// the result is allocated from resource, e.g. from a std::pmr::monotonic_buffer_resource of a request
+		/// </summary>
+		std::pmr::vector<size_t> factorize(size_t n, std::pmr::memory_resource* resource, bool repetitions = true) {
+			std::pmr::vector<size_t> prime_factors(resource);
+			this->factorize_into(prime_factors, n, repetitions);
+			return prime_factors;
+		}
+
+		size_t memory_bytes() const {
+			return sizeof(*this) + this->minimal_prime_divisors.capacity() * sizeof(size_t);
+		}
+
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
+		}
+
+	private:
+		template <class Container>
+		void factorize_into(Container& prime_factors, size_t n, bool repetitions) {
+			auto scope = this->statistics.start_query();
 			if (n >= this->get_size()) {
 				if (NumberTheory::EratosthenesSieve::is_prime_sqrt_method(n)) {
-					return { n };
+					prime_factors.push_back(n);
+					return;
 				}
 			}
-			std::vector<size_t> prime_factors;
 			size_t current_i = 0;
 			while (n >= this->get_size() && current_i < this->get_size()) {
+				this->statistics.touch();
 				if (this->is_prime(current_i) && n % current_i == 0) {
 					size_t count = 1;
 					size_t minimal_prime_divisor = current_i;
@@ -62,10 +95,11 @@ namespace NumberTheory {
 				if (n >= this->get_size() && prime_factors.size() > 0) {
 					if (NumberTheory::EratosthenesSieve::is_prime_sqrt_method(n)) {
 						prime_factors.push_back(n);
-						return prime_factors;
+						return;
 					}
 				}
 				while (n >= this->get_size()) {
+					this->statistics.touch();
 					if (n % current_i == 0 && NumberTheory::EratosthenesSieve::is_prime_sqrt_method(current_i)) {
 						size_t count = 1;
 						size_t minimal_prime_divisor = current_i;
@@ -80,6 +114,7 @@ namespace NumberTheory {
 				}
 			}
 			while (n > 1) {
+				this->statistics.touch();
 				size_t count = 0;
 				size_t minimal_prime_divisor = get_minimal_prime_divisor(n);
 				while (n % minimal_prime_divisor == 0) {
@@ -88,10 +123,8 @@ namespace NumberTheory {
 				}
 				prime_factors.insert(prime_factors.end(), ((count - 1) * repetitions + 1), minimal_prime_divisor);
 			}
-			return prime_factors;
 		}
 
-	private:
 		inline void _add_min_divisor(size_t i, size_t j) {
 			if (minimal_prime_divisors[j] == -1) {
 				minimal_prime_divisors[j] = i;
@@ -102,4 +135,6 @@ namespace NumberTheory {
 			minimal_prime_divisors[i] = i;
 		}
 	};
+
+	using Factorizer = BasicFactorizer<>;
 }
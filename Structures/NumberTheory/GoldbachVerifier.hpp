@@ -0,0 +1,188 @@
+#pragma once
+#include <bit>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <memory_resource>
+#include "WheelPrimeTable.hpp"
+#include "../Parallel.hpp"
+
+namespace NumberTheory {
+	/// <summary>
+	/// The BasicGoldbachVerifier class checks the Goldbach conjecture for all even numbers up to max_n with one shared sieve:
+	/// it finds the minimal expansions n = p + q (p &lt;= q, p is the least) and counts the expansions of every even number.
+	/// </summary>
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
+	/// <remarks>
+	/// The sieve is built once by WheelPrimeTable and kept as a bitmap of all numbers and its reversal (2 bits per number).
+	/// The minimal expansion walks the primes p from the bitmap until n - p is prime, which takes a few steps on average.
+	/// The count of expansions of n is the popcount of the bitmap on [0, n] AND-ed with the reversed bitmap shifted so that bit p meets bit n - p
+	/// (a bitset convolution), 64 pairs per AND.
+	/// Even numbers of a range are split between threads in all batch queries.
+	/// Asymptotics:
+	/// - Building: O(max_n log log max_n).
+	/// - get_expansion: O(k) for the least prime p being the k-th prime, k is small in practice.
+	/// - count_expansions: O(n / 64) for every n.
+	/// </remarks>
+	template <class Statistics = Instrumentation::NoStatistics>
+	class BasicGoldbachVerifier {
+	private:
+		size_t max_n;
+		std::pmr::vector<std::uint64_t> prime;
+		std::pmr::vector<std::uint64_t> reversed_prime; // bit i is bit max_n - i of prime
+		[[no_unique_address]] mutable Statistics statistics;
+
+		inline bool is_prime(size_t num) const {
+			return (this->prime[num >> 6] >> (num & 63)) & 1;
+		}
+
+		// 64 bits of words starting at bit first, the words are padded with a zero word
+		static inline std::uint64_t get_bits(const std::pmr::vector<std::uint64_t>& words, size_t first) {
+			size_t word = first >> 6, shift = first & 63;
+			if (shift == 0) {
+				return words[word];
+			}
+			return (words[word] >> shift) | (words[word + 1] << (64 - shift));
+		}
+
+		// the least prime greater than or equal to num, or num if there is none
+		size_t get_prime_from(size_t num) const {
+			size_t word = num >> 6;
+			if (word >= this->prime.size()) {
+				return num;
+			}
+			std::uint64_t bits = this->prime[word] & (~(std::uint64_t)0 << (num & 63));
+			while (bits == 0) {
+				if (++word == this->prime.size()) {
+					return num;
+				}
+				bits = this->prime[word];
+			}
+			return word * 64 + std::countr_zero(bits);
+		}
+
+		std::pair<size_t, size_t> get_range_of_even(size_t first, size_t last) const {
+			first = std::max<size_t>(first + first % 2, 4);
+			last = std::min(last, this->max_n);
+			return { first, first <= last ? (last - first) / 2 + 1 : 0 };
+		}
+
+	public:
+		/// <param name="max_n">the greatest number to check</param>
+		/// <param name="resource">memory resource for the bitmaps and the sieve</param>
+		BasicGoldbachVerifier(size_t max_n, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			max_n(max_n), prime(max_n / 64 + 2, 0, resource), reversed_prime(max_n / 64 + 2, 0, resource) {
+			auto scope = this->statistics.start_build();
+			WheelPrimeTable table(max_n + 1, resource);
+			table.go_through_prime_numbers([this](const size_t& p) {
+				this->prime[p >> 6] |= (std::uint64_t)1 << (p & 63);
+				size_t reversed = this->max_n - p;
+				this->reversed_prime[reversed >> 6] |= (std::uint64_t)1 << (reversed & 63);
+			});
+		}
+
+		inline size_t get_max_n() const {
+			return this->max_n;
+		}
+
+		/// <summary>
+		/// n = p + q with primes p &lt;= q and the least possible p, { 0, 0 } if there is no expansion (n is odd, too small or greater than max_n)
+		/// </summary>
+		std::pair<size_t, size_t> get_expansion(size_t n) const {
+			auto scope = this->statistics.start_query();
+			if (n < 4 || n > this->max_n) {
+				return { 0, 0 };
+			}
+			for (size_t p = this->get_prime_from(2); 2 * p <= n; p = this->get_prime_from(p + 1)) {
+				this->statistics.touch();
+				if (this->is_prime(n - p)) {
+					return { p, n - p };
+				}
+			}
+			return { 0, 0 };
+		}
+
+		/// <summary>
+		/// the minimal expansions of the even numbers from max(first, 4) to min(last, max_n) inclusive, in ascending order of n
+		/// </summary>
+		/// <param name="threads_count">the numbers are split between threads, 0 means all hardware threads</param>
+		std::vector<std::pair<size_t, size_t>> get_expansions(size_t first, size_t last, size_t threads_count = 1) const {
+			auto [first_even, count] = this->get_range_of_even(first, last);
+			std::vector<std::pair<size_t, size_t>> answer(count);
+			Parallel::parallel_for(0, count, threads_count, [&](size_t l, size_t r) {
+				for (size_t i = l; i < r; ++i) {
+					answer[i] = this->get_expansion(first_even + 2 * i);
+				}
+			});
+			return answer;
+		}
+
+		/// <summary>
+		/// the least even number from max(first, 4) to min(last, max_n) without an expansion, 0 if the conjecture holds on the range
+		/// </summary>
+		size_t find_counterexample(size_t first, size_t last, size_t threads_count = 1) const {
+			auto [first_even, count] = this->get_range_of_even(first, last);
+			std::atomic<size_t> answer = SIZE_MAX;
+			Parallel::parallel_for(0, count, threads_count, [&](size_t l, size_t r) {
+				for (size_t i = l; i < r && first_even + 2 * i < answer; ++i) {
+					size_t n = first_even + 2 * i;
+					if (this->get_expansion(n).first == 0) {
+						size_t current = answer;
+						while (n < current && !answer.compare_exchange_weak(current, n)) {}
+						return;
+					}
+				}
+			});
+			return answer == SIZE_MAX ? 0 : answer.load();
+		}
+
+		/// <summary>
+		/// count of expansions n = p + q with primes p &lt;= q
+		/// </summary>
+		size_t count_expansions(size_t n) const {
+			auto scope = this->statistics.start_query();
+			if (n > this->max_n) {
+				return 0;
+			}
+			size_t shift = this->max_n - n;
+			size_t ordered = 0;
+			for (size_t i = 0; i <= n; i += 64) {
+				std::uint64_t bits = get_bits(this->prime, i) & get_bits(this->reversed_prime, shift + i);
+				if (n - i < 63) {
+					bits &= ((std::uint64_t)1 << (n - i + 1)) - 1;
+				}
+				ordered += std::popcount(bits);
+				this->statistics.touch();
+			}
+			return (ordered + (n % 2 == 0 && this->is_prime(n / 2))) / 2;
+		}
+
+		/// <summary>
+		/// counts of expansions of the even numbers from max(first, 4) to min(last, max_n) inclusive, in ascending order of n
+		/// </summary>
+		std::vector<size_t> count_expansions(size_t first, size_t last, size_t threads_count = 1) const {
+			auto [first_even, count] = this->get_range_of_even(first, last);
+			std::vector<size_t> answer(count);
+			Parallel::parallel_for(0, count, threads_count, [&](size_t l, size_t r) {
+				for (size_t i = l; i < r; ++i) {
+					answer[i] = this->count_expansions(first_even + 2 * i);
+				}
+			}, 64);
+			return answer;
+		}
+
+		size_t memory_bytes() const {
+			return sizeof(*this) + (this->prime.capacity() + this->reversed_prime.capacity()) * sizeof(std::uint64_t);
+		}
+
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
+		}
+	};
+
+	using GoldbachVerifier = BasicGoldbachVerifier<>;
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <functional>
+#include "EratosthenesSieve.hpp"
+#include "../MappedBitArray.hpp"
+#include "../Parallel.hpp"
+
+namespace NumberTheory {
+	/// <summary>
+	/// The BasicMappedEratosthenesSieve class is an EratosthenesSieve whose bitmap lives in a file (see MappedBitArray),
+	/// so it can be built once for n larger than RAM allows and then reopened for is_prime lookups,
+	/// which page in only the parts of the bitmap they touch.
+	/// </summary>
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
+	/// <remarks>
+	/// The bitmap is filled segment by segment: every segment of segment_length numbers is set to ones
+	/// and crossed out by the primes up to sqrt(n), then its pages are released with madvise,
+	/// so building needs O(sqrt(n) + segment_length * threads_count) memory besides the page cache.
+	/// Asymptotics:
+	/// - Building: O(n log log n).
+	/// - is_prime: O(1), one page fault on the first access to a page.
+	/// </remarks>
+	template <class Statistics = Instrumentation::NoStatistics>
+	class BasicMappedEratosthenesSieve {
+	private:
+		MappedBitArray prime;
+		[[no_unique_address]] mutable Statistics statistics;
+
+		BasicMappedEratosthenesSieve(MappedBitArray&& prime) : prime(std::move(prime)) {}
+
+		void build(size_t threads_count, size_t segment_length) {
+			auto scope = this->statistics.start_build();
+			size_t n = this->prime.size();
+			size_t root = (size_t)std::sqrt((double)n) + 1;
+			while (root * root < n) {
+				++root;
+			}
+			EratosthenesSieve base(root + 1);
+			base.build();
+			auto base_primes = base.get_prime_numbers();
+
+			segment_length = std::max<size_t>((segment_length + 63) / 64 * 64, 64);
+			size_t count_of_segments = (n + segment_length - 1) / segment_length;
+			std::uint64_t* words = this->prime.get_words();
+			this->prime.advise(MappedBitArray::Access::sequential);
+			Parallel::parallel_for(0, count_of_segments, threads_count, [&](size_t first_segment, size_t last_segment) {
+				size_t crossed_out = 0;
+				for (size_t segment = first_segment; segment < last_segment; ++segment) {
+					size_t low = segment * segment_length, high = std::min(low + segment_length, n);
+					for (size_t word = low / 64; word < (high + 63) / 64; ++word) {
+						words[word] = ~(std::uint64_t)0;
+					}
+					if (high % 64 != 0) {
+						words[high / 64] &= ((std::uint64_t)1 << (high % 64)) - 1;
+					}
+					for (size_t p : base_primes) {
+						if (p * p >= high) {
+							break;
+						}
+						size_t j = std::max(p * p, (low + p - 1) / p * p);
+						for (; j < high; j += p) {
+							words[j >> 6] &= ~((std::uint64_t)1 << (j & 63));
+							++crossed_out;
+						}
+					}
+					if (low == 0) {
+						words[0] &= ~(std::uint64_t)3;
+					}
+					this->prime.advise(MappedBitArray::Access::dont_need, low, high);
+				}
+				this->statistics.touch(crossed_out);
+			}, 1);
+			this->prime.advise(MappedBitArray::Access::random);
+		}
+
+	public:
+		/// <summary>
+		/// builds the sieve of the numbers less than n into a new file at path
+		/// </summary>
+		/// <param name="threads_count">segments are sieved by this many threads, 0 means all hardware threads</param>
+		/// <param name="segment_length">count of numbers sieved at once by one thread</param>
+		BasicMappedEratosthenesSieve(const std::string& path, size_t n, size_t threads_count = 1, size_t segment_length = (size_t)1 << 24) :
+			prime(path, MappedBitArray::Mode::create, n) {
+			this->build(threads_count, segment_length);
+		}
+
+		/// <summary>
+		/// opens a sieve built before
+		/// </summary>
+		static BasicMappedEratosthenesSieve open(const std::string& path) {
+			BasicMappedEratosthenesSieve sieve(MappedBitArray(path, MappedBitArray::Mode::read_only));
+			sieve.prime.advise(MappedBitArray::Access::random);
+			return sieve;
+		}
+
+		inline size_t get_length() const {
+			return this->prime.size();
+		}
+
+		inline bool is_prime(size_t num) const {
+			auto scope = this->statistics.start_query();
+			return this->prime[num];
+		}
+
+		/// <summary>
+		/// count of primes in [l, r), reads whole words
+		/// </summary>
+		size_t count_primes(size_t l, size_t r) const {
+			r = std::min(r, this->get_length());
+			size_t answer = 0;
+			const std::uint64_t* words = this->prime.get_words();
+			while (l < r && l % 64 != 0) {
+				answer += this->prime[l++];
+			}
+			for (; l + 64 <= r; l += 64) {
+				answer += std::popcount(words[l / 64]);
+			}
+			for (; l < r; ++l) {
+				answer += this->prime[l];
+			}
+			return answer;
+		}
+
+		void go_through_prime_numbers(const std::function<void(const size_t&)>& process_prime) const {
+			const std::uint64_t* words = this->prime.get_words();
+			for (size_t word = 0; word < this->prime.get_count_of_words(); ++word) {
+				for (auto bits = words[word]; bits != 0; bits &= bits - 1) {
+					process_prime(word * 64 + std::countr_zero(bits));
+				}
+			}
+		}
+
+		void flush() {
+			this->prime.flush();
+		}
+
+		size_t memory_bytes() const {
+			return sizeof(*this);
+		}
+
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
+		}
+	};
+
+	using MappedEratosthenesSieve = BasicMappedEratosthenesSieve<>;
+}
@@ -4,3 +4,8 @@
 #include "FloorLog.hpp"
 #include "GCD&LCM.hpp"
 #include "SegmentedWheel.hpp"
+#include "MappedSieve.hpp"
+#include "WheelPrimeTable.hpp"
+#include "PrimeGapAnalytics.hpp"
+#include "GoldbachVerifier.hpp"
+#include "PrimeOracle.hpp"
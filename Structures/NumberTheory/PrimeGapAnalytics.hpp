@@ -0,0 +1,332 @@
+#pragma once
+#include <span>
+#include <array>
+#include <mutex>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <memory_resource>
+#include "SegmentedWheel.hpp"
+#include "../Parallel.hpp"
+
+namespace NumberTheory {
+	/// <summary>
+	/// constellations of consecutive primes, given by the gaps between them:
+	/// twin (2), cousin (4), triplet (2, 4 or 4, 2) and quadruplet (2, 4, 2)
+	/// </summary>
+	enum class Constellation {
+		twin, cousin, triplet, quadruplet
+	};
+
+	/// <summary>
+	/// The BasicPrimeGapAnalytics class computes prime gap statistics of the primes less than length:
+	/// the histogram of gaps between consecutive primes, the maximal gaps (gaps greater than all gaps before them)
+	/// and the counts of constellations of consecutive primes.
+	/// </summary>
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
+	/// <remarks>
+	/// The primes are read directly from the byte buffers of SegmentedWheel::SieveSegmentAt, without a callback per prime.
+	/// A table of the 256 byte values gives the primes of a byte and the constellations inside it,
+	/// so only the first primes of a byte are stepped through (for the gaps and constellations crossing into it),
+	/// and the inner gaps and constellations are counted once per byte value at the end of a range.
+	/// Every thread summarizes a contiguous range of segments:
+	/// besides the counts it keeps the first and the last primes of the range,
+	/// and the summaries are merged in order by replaying the first primes of the next range after the last primes of the previous one,
+	/// so the gaps and constellations crossing the boundaries are counted exactly once.
+	/// Constellations are counted over consecutive primes, so (3, 7) is not a cousin pair and (3, 5, 7) is not a triplet.
+	/// Asymptotics:
+	/// - Building: O(length log log length / threads_count), memory O(sqrt(length) + threads_count * (buffer + maximal gap)).
+	/// - Queries: O(1).
+	/// </remarks>
+	template <class Statistics = Instrumentation::NoStatistics>
+	class BasicPrimeGapAnalytics {
+	private:
+		static constexpr size_t count_of_constellations = 4;
+		static constexpr size_t count_of_kept_primes = 4; // the longest constellation
+		static constexpr size_t wheel = 30;
+		static constexpr size_t max_gap_in_byte = 28; // between 30k + 1 and 30k + 29
+
+		static constexpr bool matches(Constellation constellation, const size_t* gaps, size_t count_of_gaps) {
+			switch (constellation) {
+			case Constellation::twin:
+				return count_of_gaps == 1 && gaps[0] == 2;
+			case Constellation::cousin:
+				return count_of_gaps == 1 && gaps[0] == 4;
+			case Constellation::triplet:
+				return count_of_gaps == 2 && gaps[0] + gaps[1] == 6 && gaps[0] != gaps[1];
+			default:
+				return count_of_gaps == 3 && gaps[0] == 2 && gaps[1] == 4 && gaps[2] == 2;
+			}
+		}
+
+		/// <summary>
+		/// the primes of one byte of the wheel encoding and the constellations lying inside it
+		/// </summary>
+		struct BytePattern {
+			unsigned char count_of_primes;
+			std::array<unsigned char, 8> offsets;
+			std::array<unsigned char, count_of_constellations> constellation_counts;
+		};
+
+		static constexpr std::array<BytePattern, 256> byte_patterns = [] {
+			constexpr unsigned char remainders[] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+			std::array<BytePattern, 256> answer{};
+			for (size_t data = 0; data < 256; ++data) {
+				auto& pattern = answer[data];
+				for (size_t bit = 0; bit < 8; ++bit) {
+					if ((data >> bit) & 1) {
+						pattern.offsets[pattern.count_of_primes++] = remainders[bit];
+					}
+				}
+				for (size_t last = 1; last < pattern.count_of_primes; ++last) {
+					for (size_t count_of_gaps = 1; count_of_gaps <= std::min<size_t>(last, count_of_kept_primes - 1); ++count_of_gaps) {
+						size_t gaps[count_of_kept_primes - 1] = {};
+						for (size_t i = 0; i < count_of_gaps; ++i) {
+							size_t prime = last - count_of_gaps + i + 1;
+							gaps[i] = pattern.offsets[prime] - pattern.offsets[prime - 1];
+						}
+						for (size_t c = 0; c < count_of_constellations; ++c) {
+							pattern.constellation_counts[c] += matches((Constellation)c, gaps, count_of_gaps);
+						}
+					}
+				}
+			}
+			return answer;
+		}();
+
+		class Summary {
+		private:
+			std::array<size_t, 256> byte_counts{}; // bytes added by add_byte whose inner gaps and constellations are not counted yet
+
+		public:
+			size_t count_of_primes = 0;
+			std::vector<size_t> gap_histogram;
+			std::vector<std::pair<size_t, size_t>> maximal_gaps;
+			std::array<size_t, count_of_constellations> constellation_counts{};
+			std::array<size_t, count_of_kept_primes> first_primes{}, last_primes{}; // last_primes from the oldest one
+
+			size_t get_maximal_gap() const {
+				return this->maximal_gaps.empty() ? 0 : this->maximal_gaps.back().second;
+			}
+
+			/// <summary>
+			/// adds the next prime, counts only the constellations of at least min_count_of_gaps gaps ending at it,
+			/// the gap before it is added to the histogram only if min_count_of_gaps is 1
+			/// </summary>
+			void add_prime(size_t p, size_t min_count_of_gaps = 1) {
+				if (this->count_of_primes < count_of_kept_primes) {
+					this->first_primes[this->count_of_primes] = p;
+				}
+				size_t kept = std::min(this->count_of_primes, count_of_kept_primes);
+				if (kept == count_of_kept_primes) {
+					std::move(this->last_primes.begin() + 1, this->last_primes.end(), this->last_primes.begin());
+					--kept;
+				}
+				this->last_primes[kept++] = p;
+				++this->count_of_primes;
+				if (kept < 2) {
+					return;
+				}
+				size_t gap = p - this->last_primes[kept - 2];
+				if (min_count_of_gaps == 1) {
+					if (this->gap_histogram.size() <= gap) {
+						this->gap_histogram.resize(gap + 1);
+					}
+					++this->gap_histogram[gap];
+					if (gap > this->get_maximal_gap()) {
+						this->maximal_gaps.emplace_back(this->last_primes[kept - 2], gap);
+					}
+				}
+				size_t gaps[count_of_kept_primes - 1];
+				for (size_t count_of_gaps = std::max<size_t>(min_count_of_gaps, 1); count_of_gaps < kept; ++count_of_gaps) {
+					for (size_t i = 0; i < count_of_gaps; ++i) {
+						size_t last = kept - count_of_gaps + i;
+						gaps[i] = this->last_primes[last] - this->last_primes[last - 1];
+					}
+					for (size_t c = 0; c < count_of_constellations; ++c) {
+						this->constellation_counts[c] += matches((Constellation)c, gaps, count_of_gaps);
+					}
+				}
+			}
+
+			/// <summary>
+			/// adds the primes byte * 30 + offsets of data, all less than the length.
+			/// Only the primes at the beginning of the byte are stepped through to count the gaps and constellations crossing into it,
+			/// the ones inside the byte are counted once per distinct byte value by flush_byte_counts.
+			/// While the maximal gap is small, an inner gap may be a maximal one, so every prime is stepped through
+			/// </summary>
+			void add_byte(size_t byte, unsigned char data) {
+				const auto& pattern = byte_patterns[data];
+				size_t base = byte * wheel;
+				if (this->count_of_primes < count_of_kept_primes || this->get_maximal_gap() < max_gap_in_byte) {
+					for (size_t i = 0; i < pattern.count_of_primes; ++i) {
+						this->add_prime(base + pattern.offsets[i]);
+					}
+					return;
+				}
+				size_t count_of_primes = this->count_of_primes + std::popcount(data);
+				size_t stepped = std::min<size_t>(pattern.count_of_primes, count_of_kept_primes - 1);
+				for (size_t i = 0; i < stepped; ++i) {
+					this->add_prime(base + pattern.offsets[i], i + 1);
+				}
+				for (size_t i = stepped; i < pattern.count_of_primes; ++i) {
+					std::move(this->last_primes.begin() + 1, this->last_primes.end(), this->last_primes.begin());
+					this->last_primes.back() = base + pattern.offsets[i];
+				}
+				this->count_of_primes = count_of_primes;
+				++this->byte_counts[data];
+			}
+
+			/// <summary>
+			/// counts the gaps and constellations inside the bytes added by add_byte
+			/// </summary>
+			void flush_byte_counts() {
+				for (size_t data = 0; data < 256; ++data) {
+					size_t count = this->byte_counts[data];
+					if (count == 0) {
+						continue;
+					}
+					if (this->gap_histogram.size() <= max_gap_in_byte) {
+						this->gap_histogram.resize(max_gap_in_byte + 1);
+					}
+					const auto& pattern = byte_patterns[data];
+					for (size_t i = 1; i < pattern.count_of_primes; ++i) {
+						this->gap_histogram[pattern.offsets[i] - pattern.offsets[i - 1]] += count;
+					}
+					for (size_t c = 0; c < count_of_constellations; ++c) {
+						this->constellation_counts[c] += count * pattern.constellation_counts[c];
+					}
+					this->byte_counts[data] = 0;
+				}
+			}
+
+			/// <summary>
+			/// appends the summary of the next range of primes, both must be flushed
+			/// </summary>
+			void append(const Summary& other) {
+				size_t count_of_primes = this->count_of_primes + other.count_of_primes;
+				size_t replayed = std::min(other.count_of_primes, count_of_kept_primes);
+				for (size_t i = 0; i < replayed; ++i) {
+					this->add_prime(other.first_primes[i], i + 1);
+				}
+				this->count_of_primes = count_of_primes;
+				if (other.count_of_primes >= count_of_kept_primes) {
+					this->last_primes = other.last_primes;
+				}
+				if (this->gap_histogram.size() < other.gap_histogram.size()) {
+					this->gap_histogram.resize(other.gap_histogram.size());
+				}
+				for (size_t gap = 0; gap < other.gap_histogram.size(); ++gap) {
+					this->gap_histogram[gap] += other.gap_histogram[gap];
+				}
+				for (const auto& maximal_gap : other.maximal_gaps) {
+					if (maximal_gap.second > this->get_maximal_gap()) {
+						this->maximal_gaps.push_back(maximal_gap);
+					}
+				}
+				for (size_t c = 0; c < count_of_constellations; ++c) {
+					this->constellation_counts[c] += other.constellation_counts[c];
+				}
+			}
+		};
+
+		size_t length;
+		Summary summary;
+		[[no_unique_address]] mutable Statistics statistics;
+
+	public:
+		/// <param name="threads_count">segments are split into contiguous ranges between threads, 0 means all hardware threads</param>
+		/// <param name="resource">memory resource for the sieving primes and the segment buffers</param>
+		BasicPrimeGapAnalytics(size_t length, size_t threads_count = 1, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			length(length) {
+			auto scope = this->statistics.start_build();
+			BasicSegmentedWheel<> segmented_wheel(length, resource);
+			size_t count_of_bytes = segmented_wheel.GetCountOfBytes(), length_of_buffer = segmented_wheel.GetLengthOfBuffer();
+			size_t count_of_segments = count_of_bytes <= 1 ? 0 : (count_of_bytes - 1 + length_of_buffer - 1) / length_of_buffer;
+			std::vector<std::pair<size_t, Summary>> summaries;
+			std::mutex summaries_mutex;
+			auto summarize = [&](size_t first_segment, size_t last_segment) {
+				Summary range_summary;
+				if (first_segment == 0) {
+					for (size_t p : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29 }) {
+						if (p < length) {
+							range_summary.add_prime(p);
+						}
+					}
+				}
+				unsigned char* segment = static_cast<unsigned char*>(resource->allocate(length_of_buffer));
+				for (size_t segment_number = first_segment; segment_number < last_segment; ++segment_number) {
+					size_t first_byte = 1 + segment_number * length_of_buffer;
+					size_t last_byte = std::min(first_byte + length_of_buffer, count_of_bytes);
+					segmented_wheel.SieveSegmentAt(segment, first_byte, last_byte);
+					this->statistics.touch();
+					if (last_byte == count_of_bytes) { // the numbers not less than length
+						for (size_t bit = 0; bit < 8; ++bit) {
+							if ((last_byte - 1) * wheel + byte_patterns[1 << bit].offsets[0] >= length) {
+								segment[last_byte - 1 - first_byte] &= (unsigned char)~(1 << bit);
+							}
+						}
+					}
+					for (size_t byte = first_byte; byte < last_byte; ++byte) {
+						unsigned char data = segment[byte - first_byte];
+						if (data != 0) {
+							range_summary.add_byte(byte, data);
+						}
+					}
+				}
+				range_summary.flush_byte_counts();
+				resource->deallocate(segment, length_of_buffer);
+				std::lock_guard<std::mutex> lock(summaries_mutex);
+				summaries.emplace_back(first_segment, std::move(range_summary));
+			};
+			if (count_of_segments == 0) {
+				summarize(0, 0);
+			}
+			Parallel::parallel_for(0, count_of_segments, threads_count, summarize, 1);
+			std::sort(summaries.begin(), summaries.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+			for (const auto& range_summary : summaries) {
+				this->summary.append(range_summary.second);
+			}
+		}
+
+		inline size_t get_length() const {
+			return this->length;
+		}
+
+		inline size_t get_count_of_primes() const {
+			return this->summary.count_of_primes;
+		}
+
+		/// <summary>
+		/// gap_histogram[g] = count of consecutive primes p &lt; q with q - p = g
+		/// </summary>
+		std::span<const size_t> get_gap_histogram() const {
+			return this->summary.gap_histogram;
+		}
+
+		/// <summary>
+		/// pairs (p, g) of the gaps g after the primes p that are greater than all gaps before them, in ascending order
+		/// </summary>
+		std::span<const std::pair<size_t, size_t>> get_maximal_gaps() const {
+			return this->summary.maximal_gaps;
+		}
+
+		inline size_t get_count(Constellation constellation) const {
+			auto scope = this->statistics.start_query();
+			return this->summary.constellation_counts[(size_t)constellation];
+		}
+
+		size_t memory_bytes() const {
+			return sizeof(*this) + this->summary.gap_histogram.capacity() * sizeof(size_t) +
+				this->summary.maximal_gaps.capacity() * sizeof(std::pair<size_t, size_t>);
+		}
+
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
+		}
+	};
+
+	using PrimeGapAnalytics = BasicPrimeGapAnalytics<>;
+}
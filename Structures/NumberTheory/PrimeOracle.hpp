@@ -0,0 +1,309 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <memory_resource>
+#include "../Instrumentation.hpp"
+
+namespace NumberTheory {
+	/// <summary>
+	/// The BasicPrimeOracle class answers is_prime, next_prime, prev_prime and primes_in for any 64-bit numbers.
+	/// The numbers less than cache_limit are answered from a cached sieve that grows lazily with the queries,
+	/// greater numbers are checked by the deterministic Miller–Rabin test.
+	/// Not thread-safe: queries extend the cache.
+	/// </summary>
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
+	/// <remarks>
+	/// The cache is a bitmap of [0, cached_length), extended at least twice at a time,
+	/// the new part is sieved in blocks of block_length numbers by the primes already in the cache.
+	/// Asymptotics (m = cached length needed by the queries so far):
+	/// - All extensions together: O(m log log m), memory m / 8 bytes.
+	/// - is_prime: O(1) amortized in the cache, O(log^3 n) past it.
+	/// - next_prime, prev_prime: O(gap / 64) amortized in the cache, O(gap log^3 n) past it.
+	/// - primes_in(l, r): O((r - l) / 64 + count of primes) amortized in the cache.
+	/// </remarks>
+	template <class Statistics = Instrumentation::NoStatistics>
+	class BasicPrimeOracle {
+	private:
+		static constexpr size_t initial_length = 1 << 16;
+		static constexpr size_t block_length = 1 << 18;
+		static constexpr size_t largest_prime = 18446744073709551557ull; // the greatest 64-bit prime
+
+		size_t cache_limit;
+		size_t cached_length;
+		std::pmr::vector<std::uint64_t> prime;
+		[[no_unique_address]] mutable Statistics statistics;
+
+		static std::uint64_t multiply_mod(std::uint64_t a, std::uint64_t b, std::uint64_t mod) {
+			return (std::uint64_t)((unsigned __int128)a * b % mod);
+		}
+
+		static std::uint64_t power_mod(std::uint64_t a, std::uint64_t degree, std::uint64_t mod) {
+			std::uint64_t answer = 1;
+			for (a %= mod; degree != 0; degree >>= 1) {
+				if (degree & 1) {
+					answer = multiply_mod(answer, a, mod);
+				}
+				a = multiply_mod(a, a, mod);
+			}
+			return answer;
+		}
+
+		inline bool get_bit(size_t num) const {
+			return (this->prime[num >> 6] >> (num & 63)) & 1;
+		}
+
+		inline void set_false(size_t num) {
+			this->prime[num >> 6] &= ~((std::uint64_t)1 << (num & 63));
+		}
+
+		void sieve_first_part(size_t length) {
+			this->prime.assign(length / 64, ~(std::uint64_t)0);
+			this->set_false(0);
+			this->set_false(1);
+			for (size_t i = 2; i * i < length; ++i) {
+				if (this->get_bit(i)) {
+					for (size_t j = i * i; j < length; j += i) {
+						this->set_false(j);
+					}
+				}
+			}
+			this->cached_length = length;
+		}
+
+		// sieves [cached_length, length), all primes up to sqrt(length) must be cached
+		void sieve_next_part(size_t length) {
+			std::vector<size_t> base_primes;
+			for (size_t p = 2; p * p < length; ++p) {
+				if (this->get_bit(p)) {
+					base_primes.push_back(p);
+				}
+			}
+			this->prime.resize(length / 64, ~(std::uint64_t)0);
+			for (size_t low = this->cached_length; low < length; low += block_length) {
+				size_t high = std::min(low + block_length, length);
+				for (size_t p : base_primes) {
+					for (size_t j = std::max(p * p, (low + p - 1) / p * p); j < high; j += p) {
+						this->set_false(j);
+					}
+				}
+				this->statistics.touch();
+			}
+			this->cached_length = length;
+		}
+
+		/// <summary>
+		/// makes the cache cover [0, min(length, cache_limit))
+		/// </summary>
+		void extend(size_t length) {
+			length = std::min(length, this->cache_limit);
+			while (this->cached_length < length) {
+				if (this->cached_length == 0) {
+					this->sieve_first_part(std::min(initial_length, this->cache_limit));
+					continue;
+				}
+				size_t new_length = std::max(length, 2 * this->cached_length);
+				new_length = std::min((new_length + 63) / 64 * 64, this->cache_limit);
+				if (this->cached_length <= new_length / this->cached_length) { // the primes up to sqrt(new_length) are not cached yet
+					new_length = this->cached_length * this->cached_length;
+				}
+				this->sieve_next_part(new_length);
+			}
+		}
+
+		// the least prime in [num, cached_length), 0 if there is none
+		size_t find_in_cache_from(size_t num) const {
+			if (num >= this->cached_length) {
+				return 0;
+			}
+			size_t word = num >> 6;
+			std::uint64_t bits = this->prime[word] & (~(std::uint64_t)0 << (num & 63));
+			while (bits == 0) {
+				if (++word == this->prime.size()) {
+					return 0;
+				}
+				bits = this->prime[word];
+			}
+			return word * 64 + std::countr_zero(bits);
+		}
+
+		// the greatest prime in [0, num], num must be cached, 0 if there is none
+		size_t find_in_cache_to(size_t num) const {
+			size_t word = num >> 6;
+			std::uint64_t bits = this->prime[word] & (~(std::uint64_t)0 >> (63 - (num & 63)));
+			while (bits == 0) {
+				if (word == 0) {
+					return 0;
+				}
+				bits = this->prime[--word];
+			}
+			return word * 64 + std::bit_width(bits) - 1;
+		}
+
+	public:
+		/// <param name="cache_limit">numbers not less than this are checked by Miller–Rabin, the cache takes up to cache_limit / 8 bytes</param>
+		/// <param name="resource">memory resource for the cache</param>
+		BasicPrimeOracle(size_t cache_limit = (size_t)1 << 30, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			cache_limit(std::max<size_t>((cache_limit + 63) / 64 * 64, 64)), cached_length(0), prime(resource) {}
+
+		/// <summary>
+		/// deterministic for all 64-bit numbers
+		/// </summary>
+		static bool is_prime_Miller_Rabin(std::uint64_t n) {
+			if (n < 2) {
+				return false;
+			}
+			static const std::uint64_t bases[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+			for (auto p : bases) {
+				if (n % p == 0) {
+					return n == p;
+				}
+			}
+			std::uint64_t d = n - 1;
+			int s = std::countr_zero(d);
+			d >>= s;
+			for (auto a : bases) {
+				std::uint64_t x = power_mod(a, d, n);
+				if (x == 1 || x == n - 1) {
+					continue;
+				}
+				bool composite = true;
+				for (int i = 1; i < s && composite; ++i) {
+					x = multiply_mod(x, x, n);
+					composite = x != n - 1;
+				}
+				if (composite) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		inline size_t get_cached_length() const {
+			return this->cached_length;
+		}
+
+		bool is_prime(size_t num) {
+			auto scope = this->statistics.start_query();
+			if (num >= this->cache_limit) {
+				return is_prime_Miller_Rabin(num);
+			}
+			this->extend(num + 1);
+			return this->get_bit(num);
+		}
+
+		/// <summary>
+		/// the least prime greater than num, 0 if there is no such 64-bit prime
+		/// </summary>
+		size_t next_prime(size_t num) {
+			auto scope = this->statistics.start_query();
+			if (num >= largest_prime) {
+				return 0;
+			}
+			for (++num; num < this->cache_limit; num = this->cached_length) {
+				this->extend(num + 1);
+				size_t p = this->find_in_cache_from(num);
+				if (p != 0) {
+					return p;
+				}
+			}
+			while (!is_prime_Miller_Rabin(num)) {
+				this->statistics.touch();
+				++num;
+			}
+			return num;
+		}
+
+		/// <summary>
+		/// the greatest prime less than num, 0 if there is no such prime
+		/// </summary>
+		size_t prev_prime(size_t num) {
+			auto scope = this->statistics.start_query();
+			if (num <= 2) {
+				return 0;
+			}
+			for (--num; num >= this->cache_limit; --num) {
+				if (is_prime_Miller_Rabin(num)) {
+					return num;
+				}
+				this->statistics.touch();
+			}
+			this->extend(num + 1);
+			return this->find_in_cache_to(num);
+		}
+
+		/// <summary>
+		/// the primes in [l, r) in ascending order
+		/// </summary>
+		std::vector<size_t> primes_in(size_t l, size_t r) {
+			auto scope = this->statistics.start_query();
+			std::vector<size_t> answer;
+			size_t cached_r = std::min(r, this->cache_limit);
+			if (l < cached_r) {
+				this->extend(cached_r);
+				for (size_t p = this->find_in_cache_from(l); p != 0 && p < cached_r; p = this->find_in_cache_from(p + 1)) {
+					answer.push_back(p);
+				}
+			}
+			for (size_t num = std::max(l, this->cache_limit); num < r; ++num) {
+				if (is_prime_Miller_Rabin(num)) {
+					answer.push_back(num);
+				}
+			}
+			return answer;
+		}
+
+		size_t memory_bytes() const {
+			return sizeof(*this) + this->prime.capacity() * sizeof(std::uint64_t);
+		}
+
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
+		}
+	};
+
+	using PrimeOracle = BasicPrimeOracle<>;
+
+	/// <summary>
+	/// oracle shared by the calls of the helpers below in one thread
+	/// </summary>
+	inline PrimeOracle& get_default_prime_oracle() {
+		thread_local PrimeOracle oracle;
+		return oracle;
+	}
+
+	template <class Statistics>
+	std::pair<size_t, size_t> get_Goldbach_expansion(size_t n, BasicPrimeOracle<Statistics>& oracle) {
+		for (size_t i = 2; 2 * i <= n; i = oracle.next_prime(i)) {
+			if (oracle.is_prime(n - i)) {
+				return { i, n - i };
+			}
+		}
+		return { 0, 0 };
+	}
+
+	inline std::pair<size_t, size_t> get_Goldbach_expansion(size_t n) {
+		return get_Goldbach_expansion(n, get_default_prime_oracle());
+	}
+
+	template <class Statistics>
+	std::vector<size_t> make_sure_that_Bertrand_postulate_is_correct(size_t n, BasicPrimeOracle<Statistics>& oracle, bool search_all = false) {
+		if (search_all) {
+			return oracle.primes_in(n + 1, 2 * n);
+		}
+		size_t p = oracle.next_prime(n);
+		if (p < 2 * n) {
+			return { p };
+		}
+		return {};
+	}
+
+	inline std::vector<size_t> make_sure_that_Bertrand_postulate_is_correct(size_t n, bool search_all = false) {
+		return make_sure_that_Bertrand_postulate_is_correct(n, get_default_prime_oracle(), search_all);
+	}
+}
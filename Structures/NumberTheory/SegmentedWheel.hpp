@@ -2,7 +2,9 @@
 #include "EratosthenesSieve.hpp"
 
 namespace NumberTheory {
-	class SegmentedWheel {
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
+	template <class Statistics = Instrumentation::NoStatistics>
+	class BasicSegmentedWheel {
 	private:
 		const int length_of_buffer = 200 * 1024;
 		const int wheel = 30;
@@ -15,11 +17,13 @@ namespace NumberTheory {
 		static bool static_constructed;
 
 		size_t length;
-		std::vector<int> first_primes;
-		std::vector<std::vector<int>> prime_multiples;
+		std::pmr::vector<int> first_primes;
+		std::pmr::vector<std::pmr::vector<size_t>> prime_multiples;
+		std::pmr::vector<std::pmr::vector<size_t>> first_multiples; // byte of the first multiple of first_primes[j] not less than its square with the remainder wheel_remainders[i]
+		[[no_unique_address]] Statistics statistics;
 
 		static void static_constructor() {
-			if (SegmentedWheel::static_constructed) {
+			if (BasicSegmentedWheel::static_constructed) {
 				return;
 			}
 			std::vector<int> offsets;
@@ -32,7 +36,7 @@ namespace NumberTheory {
 				}
 				offsets_per_byte[b] = offsets;
 			}
-			SegmentedWheel::static_constructed = true;
+			BasicSegmentedWheel::static_constructed = true;
 		}
 
 		void SieveSegment(unsigned char* segmentData, size_t segmentStart, size_t segmentEnd) {
@@ -59,47 +63,119 @@ namespace NumberTheory {
 			}
 		}
 
+		void ResetMultiples() {
+			for (int i = 0; i < 8; ++i) {
+				for (size_t j = 0; j < first_primes.size(); ++j) {
+					prime_multiples[i][j] = first_multiples[i][j];
+				}
+			}
+		}
+
 	public:
-		SegmentedWheel(size_t length) {
+		/// <param name="resource">memory resource for the sieving primes and the segment buffer</param>
+		BasicSegmentedWheel(size_t length, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			first_primes(resource), prime_multiples(resource), first_multiples(resource) {
+			auto scope = this->statistics.start_build();
 			static_constructor();
 			this->length = length;
 			auto firstChunkLength = (size_t)std::sqrt(length) + 1;
-			NumberTheory::EratosthenesSieve sieve(firstChunkLength);
+			NumberTheory::EratosthenesSieve sieve(firstChunkLength, resource);
 			std::vector<size_t> firstPrimes;
 			auto prime_process = [&firstPrimes](const size_t& p) {firstPrimes.push_back(p);};
 			sieve.build();
 			sieve.go_through_prime_numbers(prime_process);
 			if (wheel_primes_count <= firstPrimes.size()) {
-				this->first_primes = std::vector<int>(std::begin(firstPrimes) + wheel_primes_count, std::end(firstPrimes));
+				this->first_primes.assign(std::begin(firstPrimes) + wheel_primes_count, std::end(firstPrimes));
 			}
 			prime_multiples.resize(8);
+			first_multiples.resize(8);
 			for (int i = 0; i < 8; ++i) {
 				prime_multiples[i].resize(first_primes.size());
-				for (int j = 0; j < first_primes.size(); ++j) {
-					auto prime = first_primes[j];
+				first_multiples[i].resize(first_primes.size());
+				for (size_t j = 0; j < first_primes.size(); ++j) {
+					size_t prime = first_primes[j];
 					auto val = prime * prime;
 					while (val % wheel != wheel_remainders[i]) {
 						val += 2 * prime;
 					}
-					prime_multiples[i][j] = (val - wheel_remainders[i]) / wheel;
+					first_multiples[i][j] = (val - wheel_remainders[i]) / wheel;
 				}
 			}
 		}
 
-		void ListPrimes(const std::function<void(const size_t&)>& callback) {
-			for (int i = 0; i < 10; ++i)
-				if (skipped_primes[i] < this->length)
-					callback(skipped_primes[i]);
+		size_t GetLength() const {
+			return this->length;
+		}
+
+		/// <summary>
+		/// count of bytes in the wheel encoding of the numbers less than length, byte 0 (the numbers 1 - 29) is never sieved
+		/// </summary>
+		size_t GetCountOfBytes() const {
+			return (this->length + this->wheel - 1) / this->wheel;
+		}
+
+		size_t GetLengthOfBuffer() const {
+			return this->length_of_buffer;
+		}
+
+		/// <summary>
+		/// sieves the bytes [segmentStart, segmentEnd) into segmentData like SieveSegments, but starts from the precomputed first multiples
+		/// instead of the state of the previous segment, so any segment can be sieved by any thread;
+		/// costs O(count of sieving primes) divisions more than a segment of SieveSegments
+		/// </summary>
+		void SieveSegmentAt(unsigned char* segmentData, size_t segmentStart, size_t segmentEnd) const {
+			auto segmentLength = segmentEnd - segmentStart;
+			std::fill(segmentData, segmentData + segmentLength, 255);
+			for (int i = 0; i < 8; ++i) {
+				unsigned char mask = (unsigned char)~masks[i];
+				for (size_t j = 0; j < first_primes.size(); ++j) {
+					size_t prime = first_primes[j];
+					size_t first = first_multiples[i][j];
+					if (first >= segmentEnd) {
+						continue;
+					}
+					if (first < segmentStart) {
+						first += (segmentStart - first + prime - 1) / prime * prime;
+					}
+					for (auto current = first - segmentStart; current < segmentLength; current += prime) {
+						segmentData[current] &= mask;
+					}
+				}
+			}
+		}
+
+		/// <summary>
+		/// sieves the numbers from 30 to length segment by segment and calls process_segment(segmentData, segmentStart, segmentEnd) for every segment:
+		/// segmentData[i] describes the numbers (segmentStart + i) * 30 + wheel_remainders[k], bit k is set if the number is prime
+		/// (numbers not less than length in the last byte are not cleared), the buffer is reused for the next segment
+		/// </summary>
+		void SieveSegments(const std::function<void(const unsigned char*, size_t, size_t)>& process_segment) {
+			ResetMultiples();
 			size_t max_ = (this->length + this->wheel - 1) / this->wheel;
-			unsigned char* segmentData = new unsigned char[length_of_buffer];
+			auto resource = this->first_primes.get_allocator().resource();
+			unsigned char* segmentData = static_cast<unsigned char*>(resource->allocate(length_of_buffer));
 			size_t segmentStart = 1;
 			auto segmentEnd = std::min(segmentStart + length_of_buffer, max_);
 			while (segmentStart < max_) {
 				SieveSegment(segmentData, segmentStart, segmentEnd);
-				for (int i = 0; i < length_of_buffer; ++i) {
+				this->statistics.touch();
+				process_segment(segmentData, segmentStart, segmentEnd);
+				segmentStart = segmentEnd;
+				segmentEnd = std::min(segmentStart + this->length_of_buffer, max_);
+			}
+			resource->deallocate(segmentData, length_of_buffer);
+		}
+
+		void ListPrimes(const std::function<void(const size_t&)>& callback) {
+			auto scope = this->statistics.start_query();
+			for (int i = 0; i < 10; ++i)
+				if (skipped_primes[i] < this->length)
+					callback(skipped_primes[i]);
+			SieveSegments([&](const unsigned char* segmentData, size_t segmentStart, size_t segmentEnd) {
+				for (size_t i = 0; i < segmentEnd - segmentStart; ++i) {
 					auto offset = (segmentStart + i) * this->wheel;
 					auto data = segmentData[i];
-					auto& current_offsets = SegmentedWheel::offsets_per_byte[data];
+					auto& current_offsets = BasicSegmentedWheel::offsets_per_byte[data];
 					for (int j = 0; j < current_offsets.size(); ++j) {
 						auto p = offset + current_offsets[j];
 						if (p >= this->length) {
@@ -108,16 +184,37 @@ namespace NumberTheory {
 						callback(p);
 					}
 				}
-				segmentStart = segmentEnd;
-				segmentEnd = std::min(segmentStart + this->length_of_buffer, max_);
+			});
+		}
+
+		size_t memory_bytes() const {
+			size_t answer = sizeof(*this) + this->first_primes.capacity() * sizeof(int);
+			for (const auto& multiples : this->prime_multiples) {
+				answer += sizeof(multiples) + multiples.capacity() * sizeof(size_t);
+			}
+			for (const auto& multiples : this->first_multiples) {
+				answer += sizeof(multiples) + multiples.capacity() * sizeof(size_t);
 			}
-			delete[] segmentData;
+			return answer;
+		}
+
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
 		}
 	};
 
-	int SegmentedWheel::wheel_remainders[] = { 1, 7, 11, 13, 17, 19, 23, 29 };
-	int SegmentedWheel::skipped_primes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29 };
-	unsigned char SegmentedWheel::masks[] = { 1, 2, 4, 8, 16, 32, 64, 128 };
-	std::vector<int> SegmentedWheel::offsets_per_byte[256];
-	bool SegmentedWheel::static_constructed = false;
+	template <class Statistics>
+	int BasicSegmentedWheel<Statistics>::wheel_remainders[] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+	template <class Statistics>
+	int BasicSegmentedWheel<Statistics>::skipped_primes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29 };
+	template <class Statistics>
+	unsigned char BasicSegmentedWheel<Statistics>::masks[] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+	template <class Statistics>
+	std::vector<int> BasicSegmentedWheel<Statistics>::offsets_per_byte[256];
+	template <class Statistics>
+	bool BasicSegmentedWheel<Statistics>::static_constructed = false;
+
+	using SegmentedWheel = BasicSegmentedWheel<>;
 }
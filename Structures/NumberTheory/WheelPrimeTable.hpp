@@ -0,0 +1,180 @@
+#pragma once
+#include <bit>
+#include <array>
+#include <algorithm>
+#include <functional>
+#include <memory_resource>
+#include "SegmentedWheel.hpp"
+
+namespace NumberTheory {
+	/// <summary>
+	/// The BasicWheelPrimeTable class answers is_prime for the numbers less than length like EratosthenesSieve,
+	/// but stores only the numbers coprime to 30: byte k describes 30k + 1, 30k + 7, ..., 30k + 29 (the SegmentedWheel encoding),
+	/// so it takes length / 30 bytes, 3.75 times less than a bitmap of all numbers.
+	/// </summary>
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
+	/// <remarks>
+	/// The table is filled from the segments of SegmentedWheel::SieveSegments.
+	/// Asymptotics:
+	/// - Building: O(length log log length).
+	/// - is_prime: O(1).
+	/// - next_prime, prev_prime: O(gap / 30), a whole byte is checked at once.
+	/// </remarks>
+	template <class Statistics = Instrumentation::NoStatistics>
+	class BasicWheelPrimeTable {
+	private:
+		static constexpr size_t wheel = 30;
+		static constexpr size_t remainders[] = { 1, 7, 11, 13, 17, 19, 23, 29 };
+
+		// bit of the remainder, 8 for the remainders not coprime to 30
+		static constexpr std::array<unsigned char, wheel> bit_of_remainder = [] {
+			std::array<unsigned char, wheel> answer{};
+			answer.fill(8);
+			for (unsigned char i = 0; i < 8; ++i) {
+				answer[remainders[i]] = i;
+			}
+			return answer;
+		}();
+
+		// bits of the remainders not less than the remainder
+		static constexpr std::array<unsigned char, wheel + 1> mask_from = [] {
+			std::array<unsigned char, wheel + 1> answer{};
+			for (size_t r = 0; r <= wheel; ++r) {
+				for (size_t i = 0; i < 8; ++i) {
+					if (remainders[i] >= r) {
+						answer[r] |= 1 << i;
+					}
+				}
+			}
+			return answer;
+		}();
+
+		size_t length;
+		std::pmr::vector<unsigned char> bytes;
+		[[no_unique_address]] mutable Statistics statistics;
+
+		inline size_t get_number(size_t byte, unsigned char bit) const {
+			return byte * wheel + remainders[bit];
+		}
+
+	public:
+		/// <param name="resource">memory resource for the table and the sieve</param>
+		BasicWheelPrimeTable(size_t length, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			length(length), bytes((length + wheel - 1) / wheel, 0, resource) {
+			auto scope = this->statistics.start_build();
+			if (this->bytes.empty()) {
+				return;
+			}
+			this->bytes[0] = 0xFE; // 7, 11, ..., 29 are prime, 1 is not
+			BasicSegmentedWheel<> segmented_wheel(length, resource);
+			segmented_wheel.SieveSegments([this](const unsigned char* segment, size_t first_byte, size_t last_byte) {
+				std::copy(segment, segment + (last_byte - first_byte), this->bytes.begin() + first_byte);
+				this->statistics.touch(last_byte - first_byte);
+			});
+			size_t last_byte = this->bytes.size() - 1;
+			for (unsigned char i = 0; i < 8; ++i) {
+				if (this->get_number(last_byte, i) >= length) {
+					this->bytes[last_byte] &= (unsigned char)~(1 << i);
+				}
+			}
+		}
+
+		inline size_t get_length() const {
+			return this->length;
+		}
+
+		/// <summary>
+		/// num must be less than get_length()
+		/// </summary>
+		inline bool is_prime(size_t num) const {
+			auto scope = this->statistics.start_query();
+			if (num < 7) {
+				return num == 2 || num == 3 || num == 5;
+			}
+			unsigned char bit = bit_of_remainder[num % wheel];
+			return bit != 8 && ((this->bytes[num / wheel] >> bit) & 1);
+		}
+
+		/// <summary>
+		/// the least prime greater than num, 0 if there is no such prime less than get_length()
+		/// </summary>
+		size_t next_prime(size_t num) const {
+			auto scope = this->statistics.start_query();
+			for (size_t p : { 2, 3, 5 }) {
+				if (num < p) {
+					return p < this->length ? p : 0;
+				}
+			}
+			size_t byte = (num + 1) / wheel;
+			if (byte >= this->bytes.size()) {
+				return 0;
+			}
+			unsigned char mask = this->bytes[byte] & mask_from[(num + 1) % wheel];
+			while (mask == 0) {
+				this->statistics.touch();
+				if (++byte == this->bytes.size()) {
+					return 0;
+				}
+				mask = this->bytes[byte];
+			}
+			return this->get_number(byte, (unsigned char)std::countr_zero(mask));
+		}
+
+		/// <summary>
+		/// the greatest prime less than num, 0 if there is no such prime
+		/// </summary>
+		size_t prev_prime(size_t num) const {
+			auto scope = this->statistics.start_query();
+			num = std::min(num, this->length);
+			if (num <= 7) {
+				return num <= 2 ? 0 : (num <= 3 ? 2 : (num <= 5 ? 3 : 5));
+			}
+			size_t byte = (num - 1) / wheel;
+			unsigned char mask = this->bytes[byte] & (unsigned char)~mask_from[(num - 1) % wheel + 1];
+			while (mask == 0) {
+				this->statistics.touch();
+				if (byte == 0) {
+					return 5;
+				}
+				mask = this->bytes[--byte];
+			}
+			return this->get_number(byte, (unsigned char)(std::bit_width(mask) - 1));
+		}
+
+		size_t get_count_of_primes() const {
+			size_t answer = 0;
+			for (unsigned char byte : this->bytes) {
+				answer += std::popcount(byte);
+			}
+			for (size_t p : { 2, 3, 5 }) {
+				answer += p < this->length;
+			}
+			return answer;
+		}
+
+		void go_through_prime_numbers(const std::function<void(const size_t&)>& process_prime) const {
+			for (size_t p : { 2, 3, 5 }) {
+				if (p < this->length) {
+					process_prime(p);
+				}
+			}
+			for (size_t byte = 0; byte < this->bytes.size(); ++byte) {
+				for (unsigned char mask = this->bytes[byte]; mask != 0; mask &= mask - 1) {
+					process_prime(this->get_number(byte, (unsigned char)std::countr_zero(mask)));
+				}
+			}
+		}
+
+		size_t memory_bytes() const {
+			return sizeof(*this) + this->bytes.capacity();
+		}
+
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
+		}
+	};
+
+	using WheelPrimeTable = BasicWheelPrimeTable<>;
+}
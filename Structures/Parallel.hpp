@@ -0,0 +1,46 @@
+#pragma once
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace Parallel {
+	/// <summary>
+	/// threads_count == 0 means "as many threads as the hardware supports"
+	/// </summary>
+	inline size_t get_threads_count(size_t threads_count) {
+		if (threads_count == 0) {
+			threads_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		}
+		return threads_count;
+	}
+
+	/// <summary>
+	/// splits [begin, end) into contiguous chunks and calls process_range(l, r) for each of them,
+	/// the calling thread processes the first chunk itself
+	/// </summary>
+	/// <param name="min_chunk_length">ranges shorter than this are not worth a thread</param>
+	template <class Function>
+	void parallel_for(size_t begin, size_t end, size_t threads_count, const Function& process_range, size_t min_chunk_length = 1 << 12) {
+		if (begin >= end) {
+			return;
+		}
+		size_t length = end - begin;
+		threads_count = std::min(get_threads_count(threads_count), std::max<size_t>(length / std::max<size_t>(min_chunk_length, 1), 1));
+		if (threads_count <= 1) {
+			process_range(begin, end);
+			return;
+		}
+		size_t chunk_length = (length + threads_count - 1) / threads_count;
+		std::vector<std::thread> threads;
+		threads.reserve(threads_count - 1);
+		for (size_t l = begin + chunk_length; l < end; l += chunk_length) {
+			threads.emplace_back([&process_range, l, end, chunk_length]() {
+				process_range(l, std::min(l + chunk_length, end));
+			});
+		}
+		process_range(begin, std::min(begin + chunk_length, end));
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <memory_resource>
+
+namespace QueryStructures {
+	/// <summary>
+	/// The ConcurrentSegmentTree class is a SegmentTree that can be shared between
+	/// many query threads and updater threads without an external mutex.
+	/// </summary>
+	/// <typeparam name="T">T must be trivially copyable and fit into a lock-free std::atomic</typeparam>
+	///
+	/// <remarks>
+	/// Every vertex is stored in its own std::atomic, so readers never take a lock.
+	/// A single change_value is visible to a reader either completely or not at all,
+	/// because the vertices read by one query cover disjoint segments.
+	/// change_values applies a whole batch under a sequence lock: readers that overlap
+	/// with the batch retry, so they observe either none or all of its changes.
+	/// Updaters are serialized among themselves by a mutex that readers never touch.
+	/// Asymptotics:
+	/// - Query operation (ask_value_on): O(log N), without locking.
+	/// - Point update (change_value): O(log N).
+	/// - Batch update (change_values): O(K log N) for K changes, each common ancestor is recomputed once.
+	/// </remarks>
+	template <class T>
+	class ConcurrentSegmentTree {
+		static_assert(std::is_trivially_copyable<T>::value, "Type T must be trivially copyable");
+		static_assert(std::atomic<T>::is_always_lock_free, "std::atomic<T> must be lock-free");
+
+	private:
+		using Change = std::pair<size_t, T>;
+		using ChangeIterator = typename std::vector<Change>::const_iterator;
+
+		size_t n;
+		std::pmr::vector<std::atomic<T>> t;
+		std::function<T(T, T)> f;
+
+		std::atomic<size_t> version;
+		std::mutex updaters_mutex;
+
+		struct Children {
+			size_t left;
+			size_t right;
+
+			Children(size_t left, size_t right) : left(left), right(right) {}
+			Children(size_t vertex_number) : Children(2 * vertex_number + 1, 2 * vertex_number + 2) {}
+		};
+
+		T load(size_t vertex_number) const {
+			return this->t[vertex_number].load(std::memory_order_relaxed);
+		}
+
+		void store(size_t vertex_number, const T& value) {
+			this->t[vertex_number].store(value, std::memory_order_relaxed);
+		}
+
+		void pull(size_t vertex_number) {
+			Children children(vertex_number);
+			this->store(vertex_number, this->f(this->load(children.left), this->load(children.right)));
+		}
+
+		void build(const std::vector<T>& a, size_t vertex_number, size_t l, size_t r) {
+			if (l == r - 1) {
+				this->store(vertex_number, a[l]);
+				return;
+			}
+			auto m = (l + r) / 2;
+			Children children(vertex_number);
+			build(a, children.left, l, m);
+			build(a, children.right, m, r);
+			this->pull(vertex_number);
+		}
+
+		T ask(size_t vertex_number, size_t l, size_t r, size_t askl, size_t askr) const { // r & askr are not included
+			if (askl <= l && r <= askr) {
+				return this->load(vertex_number);
+			}
+			Children children(vertex_number);
+			auto m = (l + r) / 2;
+			if (askr <= m) {
+				return ask(children.left, l, m, askl, askr);
+			}
+			if (m <= askl) {
+				return ask(children.right, m, r, askl, askr);
+			}
+			return f(ask(children.left, l, m, askl, askr), ask(children.right, m, r, askl, askr));
+		}
+
+		void alter(size_t vertex_number, size_t l, size_t r, size_t position, const T& value) {
+			if (l == r - 1) {
+				this->store(vertex_number, value);
+				return;
+			}
+			Children children(vertex_number);
+			size_t m = (l + r) / 2;
+			if (position < m) {
+				alter(children.left, l, m, position, value);
+			}
+			else {
+				alter(children.right, m, r, position, value);
+			}
+			this->pull(vertex_number);
+		}
+
+		/// <summary>
+		/// applies the changes from [begin, end), which are sorted by position and have no repeated positions
+		/// </summary>
+		void alter(size_t vertex_number, size_t l, size_t r, ChangeIterator begin, ChangeIterator end) {
+			if (begin == end) {
+				return;
+			}
+			if (l == r - 1) {
+				this->store(vertex_number, begin->second);
+				return;
+			}
+			Children children(vertex_number);
+			size_t m = (l + r) / 2;
+			auto middle = std::lower_bound(begin, end, m, [](const Change& change, size_t position) {
+				return change.first < position;
+			});
+			alter(children.left, l, m, begin, middle);
+			alter(children.right, m, r, middle, end);
+			this->pull(vertex_number);
+		}
+
+	public:
+		ConcurrentSegmentTree(const std::vector<T>& a, const std::function<T(T, T)>& f, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			n(a.size()), t(4 * a.size(), resource), f(f), version(0) {
+			if (this->n > 0) {
+				this->build(a, 0, 0, n);
+			}
+		}
+
+		size_t get_size() const {
+			return this->n;
+		}
+
+		T ask_value_on(size_t left, size_t right) const {
+			while (true) {
+				auto before = this->version.load(std::memory_order_acquire);
+				if (before & 1) {
+					std::this_thread::yield(); // a batch is being written
+					continue;
+				}
+				T answer = ask(0, 0, this->n, left, right + 1);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (this->version.load(std::memory_order_relaxed) == before) {
+					return answer;
+				}
+			}
+		}
+
+		void change_value(size_t position, const T& value) {
+			std::lock_guard<std::mutex> lock(this->updaters_mutex);
+			alter(0, 0, this->n, position, value);
+		}
+
+		/// <summary>
+		/// applies all changes atomically with respect to ask_value_on,
+		/// if a position is repeated, the last change of it wins
+		/// </summary>
+		void change_values(std::vector<Change> changes) {
+			if (changes.empty()) {
+				return;
+			}
+			std::stable_sort(changes.begin(), changes.end(), [](const Change& a, const Change& b) {
+				return a.first < b.first;
+			});
+			auto last_of_each = std::unique(changes.rbegin(), changes.rend(), [](const Change& a, const Change& b) {
+				return a.first == b.first;
+			});
+			changes.erase(changes.begin(), last_of_each.base());
+
+			std::lock_guard<std::mutex> lock(this->updaters_mutex);
+			auto current_version = this->version.load(std::memory_order_relaxed);
+			this->version.store(current_version + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			alter(0, 0, this->n, changes.cbegin(), changes.cend());
+			this->version.store(current_version + 2, std::memory_order_release);
+		}
+	};
+}
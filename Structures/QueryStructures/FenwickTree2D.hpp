@@ -0,0 +1,95 @@
+#pragma once
+#include <vector>
+#include <type_traits>
+#include <memory_resource>
+
+namespace QueryStructures {
+	/// <summary>
+	/// The FenwickTree2D class represents a data structure
+	/// for sums on a rectangle of a grid with point updates.
+	/// </summary>
+	/// <typeparam name="T">Type T must have operator+ and operator-</typeparam>
+	///
+	/// <remarks>
+	/// The tree is one rows x cols array in row-major order.
+	/// Asymptotics:
+	/// - Building the data structure: O(R C).
+	/// - Query operation (ask_value): O(log R log C).
+	/// - Point update (add, change_value): O(log R log C).
+	/// </remarks>
+	template <class T>
+	class FenwickTree2D {
+	private:
+		size_t rows, cols;
+		std::pmr::vector<T> tree;
+
+		T ask_prefix(size_t bottom, size_t right) const { // sum on [0, bottom) x [0, right)
+			T answer = T();
+			for (size_t i = bottom; i > 0; i &= i - 1) {
+				const T* row = &this->tree[(i - 1) * this->cols];
+				for (size_t j = right; j > 0; j &= j - 1) {
+					answer = answer + row[j - 1];
+				}
+			}
+			return answer;
+		}
+
+	public:
+		FenwickTree2D(size_t rows, size_t cols, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			rows(rows), cols(cols), tree(rows * cols, resource) {}
+
+		/// <param name="grid">rows x cols values in row-major order</param>
+		FenwickTree2D(const std::vector<T>& grid, size_t rows, size_t cols, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			rows(rows), cols(cols), tree(grid.begin(), grid.begin() + rows * cols, resource) {
+			static_assert(std::is_same<decltype(T() + T()), T>::value, "Type T must have operator+");
+			for (size_t i = 0; i < this->rows; ++i) {
+				T* row = &this->tree[i * this->cols];
+				for (size_t j = 1; j <= this->cols; ++j) {
+					size_t parent = j + (j & (0 - j));
+					if (parent <= this->cols) {
+						row[parent - 1] = row[parent - 1] + row[j - 1];
+					}
+				}
+			}
+			for (size_t i = 1; i <= this->rows; ++i) {
+				size_t parent = i + (i & (0 - i));
+				if (parent <= this->rows) {
+					T* parent_row = &this->tree[(parent - 1) * this->cols];
+					const T* row = &this->tree[(i - 1) * this->cols];
+					for (size_t j = 0; j < this->cols; ++j) {
+						parent_row[j] = parent_row[j] + row[j];
+					}
+				}
+			}
+		}
+
+		size_t get_count_of_rows() const {
+			return this->rows;
+		}
+
+		size_t get_count_of_cols() const {
+			return this->cols;
+		}
+
+		void add(size_t row, size_t col, const T& delta) {
+			for (size_t i = row + 1; i <= this->rows; i += i & (0 - i)) {
+				T* current = &this->tree[(i - 1) * this->cols];
+				for (size_t j = col + 1; j <= this->cols; j += j & (0 - j)) {
+					current[j - 1] = current[j - 1] + delta;
+				}
+			}
+		}
+
+		void change_value(size_t row, size_t col, const T& value) {
+			this->add(row, col, value - this->ask_value(row, col, row, col));
+		}
+
+		/// <summary>
+		/// sum on the rectangle [top, bottom] x [left, right]
+		/// </summary>
+		T ask_value(size_t top, size_t left, size_t bottom, size_t right) const {
+			return this->ask_prefix(bottom + 1, right + 1) - this->ask_prefix(top, right + 1)
+				- this->ask_prefix(bottom + 1, left) + this->ask_prefix(top, left);
+		}
+	};
+}
@@ -1,14 +1,16 @@
 #pragma once
 #include <vector>
+#include <memory_resource>
 
 namespace QueryStructures {
 	template <class T>
 	class PrefixAmounts {
 	private:
-		std::vector<T> prefix_amounts;
+		std::pmr::vector<T> prefix_amounts;
 	public:
 		PrefixAmounts() = delete;
-		PrefixAmounts(const std::vector<T>& container) {
+		PrefixAmounts(const std::vector<T>& container, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			prefix_amounts(resource) {
 			static_assert(std::is_same<decltype(T() + T()), T>::value, "Type T must have operator+");
 			prefix_amounts.resize(container.size());
 			prefix_amounts[0] = container[0];
@@ -3,3 +3,7 @@
 #include "SegmentTree.hpp"
 #include "RootDecomposition.hpp"
 #include "PrefixAmounts.hpp"
+#include "ConcurrentSegmentTree.hpp"
+#include "WaveletMatrix.hpp"
+#include "SparseTable2D.hpp"
+#include "FenwickTree2D.hpp"
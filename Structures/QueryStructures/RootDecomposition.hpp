@@ -2,6 +2,9 @@
 #include <vector>
 #include <optional>
 #include <functional>
+#include <memory_resource>
+#include "..//Parallel.hpp"
+#include "..//Instrumentation.hpp"
 
 namespace QueryStructures {
 	template <class T>
@@ -19,12 +22,13 @@ namespace QueryStructures {
 		return answer;
 	}
 
-	template <class T>
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
+	template <class T, class Statistics = Instrumentation::NoStatistics>
 	class RootDecomposition {
 	private:
 		class Block {
 		private:
-			std::vector<T> block;
+			std::pmr::vector<T> block;
 			std::optional<T> result_of_operation;
 			std::optional<T> coefficient_not_yet_used;
 
@@ -41,12 +45,19 @@ namespace QueryStructures {
 				}
 			}
 		public:
-			Block(const BinaryFunction<T>& f, const ExponentiateFunction<T>& fexp) : f(f), fexp(fexp) {}
+			Block(const BinaryFunction<T>& f, const ExponentiateFunction<T>& fexp, size_t capacity, std::pmr::memory_resource* resource) :
+				block(resource), f(f), fexp(fexp) {
+				block.reserve(capacity);
+			}
 
 			size_t get_length() const {
 				return block.size();
 			}
 
+			size_t memory_bytes() const {
+				return sizeof(*this) + block.capacity() * sizeof(T);
+			}
+
 			const T& operator[](const size_t index) const {
 				return this->block[index];
 			}
@@ -95,30 +106,46 @@ namespace QueryStructures {
 		};
 
 		size_t length;
-		std::vector<Block> blocks;
+		std::pmr::vector<Block> blocks;
 		size_t block_length, block_count;
 		BinaryFunction<T> f;
 		ExponentiateFunction<T> fexp;
+		[[no_unique_address]] Statistics statistics;
 
 	public:
 		RootDecomposition() = delete;
+		/// <param name="threads_count">blocks are built by this many threads, 0 means all hardware threads</param>
+		/// <param name="resource">memory resource for the blocks</param>
 		RootDecomposition(
 			const std::vector<T>& a,
 			const BinaryFunction<T>& f,
-			const ExponentiateFunction<T>& fexp = generic_exponentiate<T>) :
+			const ExponentiateFunction<T>& fexp = generic_exponentiate<T>,
+			size_t threads_count = 1,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
 			f(f),
 			length(a.size()),
+			blocks(resource),
 			fexp(fexp),
 			block_length((size_t)sqrt(length)),
 			block_count(0) {
-			for (int i = 0; i < length; ++i) {
-				int number_block_with_a_i = i / block_length;
-				if (block_count == number_block_with_a_i) {
-					blocks.push_back(Block(this->f, this->fexp));
-					++block_count;
+			auto scope = this->statistics.start_build();
+			if (this->length == 0) {
+				return;
+			}
+			block_count = (length + block_length - 1) / block_length;
+			blocks.reserve(block_count);
+			for (size_t block_number = 0; block_number < block_count; ++block_number) {
+				blocks.emplace_back(this->f, this->fexp, std::min(block_length, length - block_number * block_length), resource);
+			}
+			size_t min_blocks_per_thread = 16;
+			Parallel::parallel_for(0, block_count, threads_count, [this, &a](size_t first_block, size_t last_block) {
+				for (size_t block_number = first_block; block_number < last_block; ++block_number) {
+					size_t end = std::min(this->length, (block_number + 1) * block_length);
+					for (size_t i = block_number * block_length; i < end; ++i) {
+						blocks[block_number].add_new_element(a[i]);
+					}
 				}
-				blocks[number_block_with_a_i].add_new_element(a[i]);
-			}
+			}, min_blocks_per_thread);
 		}
 
 		size_t get_length() const {
@@ -132,6 +159,7 @@ namespace QueryStructures {
 		}
 
 		std::optional<T> get_result_on(size_t l, size_t r) {
+			auto scope = this->statistics.start_query();
 			std::optional<T> answer;
 			if (!(0 <= l && l <= r && r < this->get_length())) {
 				return answer;
@@ -142,8 +170,10 @@ namespace QueryStructures {
 				right_block_number = r / block_length,
 				position_in_right = r % block_length;
 			if (left_block_number == right_block_number) {
+				this->statistics.touch();
 				return blocks[left_block_number].get_part_result_on(position_in_left, position_in_right);
 			}
+			this->statistics.touch(right_block_number - left_block_number + 1);
 			bool left_block_taken_partially = position_in_left != 0;
 			bool right_block_taken_partially = position_in_right != blocks[right_block_number].get_length() - 1;
 			if (left_block_taken_partially) {
@@ -173,13 +203,16 @@ namespace QueryStructures {
 		}
 
 		void act(size_t l, size_t r, T x) {
+			auto scope = this->statistics.start_update();
 			size_t left_block_number = l / block_length,
 				position_in_left = l % block_length,
 				right_block_number = r / block_length,
 				position_in_right = r % block_length;
 			if (left_block_number == right_block_number) {
+				this->statistics.touch();
 				return blocks[left_block_number].act_on_part_of_block(position_in_left, position_in_right, x);
 			}
+			this->statistics.touch(right_block_number - left_block_number + 1);
 			bool left_block_taken_partially = position_in_left != 0;
 			bool right_block_taken_partially = position_in_right != blocks[right_block_number].get_length() - 1;
 			if (left_block_taken_partially) {
@@ -194,6 +227,20 @@ namespace QueryStructures {
 				blocks[i].affect_entire_block(x);
 			}
 		}
+
+		size_t memory_bytes() const {
+			size_t answer = sizeof(*this) + (this->blocks.capacity() - this->blocks.size()) * sizeof(Block);
+			for (const auto& block : this->blocks) {
+				answer += block.memory_bytes();
+			}
+			return answer;
+		}
+
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
+		}
 	};
 }
 
@@ -2,15 +2,21 @@
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <thread>
+#include <memory_resource>
+#include "..//Parallel.hpp"
+#include "..//Instrumentation.hpp"
 
 namespace QueryStructures {
-	template <class T>
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
+	template <class T, class Statistics = Instrumentation::NoStatistics>
 	class SegmentTree {
 	private:
 		size_t n;
-		std::vector<T> a;
-		std::vector<T> t;
+		std::pmr::vector<T> a;
+		std::pmr::vector<T> t;
 		std::function<T(T, T)> f;
+		[[no_unique_address]] Statistics statistics;
 
 		struct Children {
 			size_t left;
@@ -20,31 +26,47 @@ namespace QueryStructures {
 			Children(size_t vertex_number) : Children(2 * vertex_number + 1, 2 * vertex_number + 2) {}
 		};
 
-		void build(size_t vertex_number, size_t l, size_t r) {
+		void build(size_t vertex_number, size_t l, size_t r, size_t threads_count = 1) {
 			if (l == r - 1) {
 				this->t[vertex_number] = this->a[l];
 				return;
 			}
 			auto m = (l + r) / 2;
 			Children children(vertex_number);
-			build(children.left, l, m);
-			build(children.right, m, r);
+			size_t min_parallel_length = 1 << 12;
+			if (threads_count > 1 && r - l >= min_parallel_length) { // subtrees are disjoint, so the left one is built by another thread
+				size_t left_threads_count = threads_count / 2;
+				std::thread left_builder([this, &children, l, m, left_threads_count]() {
+					build(children.left, l, m, left_threads_count);
+				});
+				build(children.right, m, r, threads_count - left_threads_count);
+				left_builder.join();
+			}
+			else {
+				build(children.left, l, m);
+				build(children.right, m, r);
+			}
 			this->t[vertex_number] = this->f(this->t[children.left], this->t[children.right]);
 		}
 
-		size_t ask(size_t vertex_number, size_t l, size_t r, size_t askl, size_t askr) { // r & askr are not included
-			if (r <= askl || askr <= l) {
-				return 0; // vertex is red
-			}
+		T ask(size_t vertex_number, size_t l, size_t r, size_t askl, size_t askr) { // r & askr are not included
+			this->statistics.touch();
 			if (askl <= l && r <= askr) {
 				return t[vertex_number]; // vertex is green
 			}
 			Children children(vertex_number);
 			auto m = (l + r) / 2;
+			if (askr <= m) {
+				return ask(children.left, l, m, askl, askr); // right child is red
+			}
+			if (m <= askl) {
+				return ask(children.right, m, r, askl, askr); // left child is red
+			}
 			return f(ask(children.left, l, m, askl, askr), ask(children.right, m, r, askl, askr)); // vertex is yellow
 		}
 
 		void alter(size_t vertex_number, size_t l, size_t r, size_t position, const T& value) {
+			this->statistics.touch();
 			if (l == r - 1) {
 				this->t[vertex_number] = value;
 				return;
@@ -61,17 +83,60 @@ namespace QueryStructures {
 		}
 
 	public:
-		SegmentTree(const std::vector<T>& a, const std::function<T(T, T)>& f) : n(a.size()), a(a), f(f) {
+		/// <param name="threads_count">the tree is built by this many threads, 0 means all hardware threads</param>
+		/// <param name="resource">memory resource for the vertices</param>
+		SegmentTree(
+			const std::vector<T>& a,
+			const std::function<T(T, T)>& f,
+			size_t threads_count = 1,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			n(a.size()), a(a.begin(), a.end(), resource), t(resource), f(f) {
+			auto scope = this->statistics.start_build();
 			this->t.resize(4 * this->n);
-			this->build(0, 0, n);
+			this->build(0, 0, n, Parallel::get_threads_count(threads_count));
+		}
+
+		/// <summary>
+		/// the tree of n copies of value
+		/// </summary>
+		SegmentTree(
+			size_t n,
+			const T& value,
+			const std::function<T(T, T)>& f,
+			size_t threads_count = 1,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			n(n), a(n, value, resource), t(resource), f(f) {
+			auto scope = this->statistics.start_build();
+			this->t.resize(4 * this->n);
+			this->build(0, 0, n, Parallel::get_threads_count(threads_count));
+		}
+
+		/// <summary>
+		/// the current value at position
+		/// </summary>
+		const T& get_value(size_t position) const {
+			return this->a[position];
 		}
 
 		T ask_value_on(size_t left, size_t right) {
+			auto scope = this->statistics.start_query();
 			return ask(0, 0, this->n, left, right + 1);
 		}
 
 		void change_value(size_t position, const T& value) {
+			auto scope = this->statistics.start_update();
+			this->a[position] = value;
 			alter(0, 0, this->n, position, value);
 		}
+
+		size_t memory_bytes() const {
+			return sizeof(*this) + (this->a.capacity() + this->t.capacity()) * sizeof(T);
+		}
+
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
+		}
 	};
 }
@@ -1,30 +1,39 @@
 #pragma once
 #include "..//NumberTheory//FloorLog.hpp"
+#include "..//Parallel.hpp"
+#include "..//Instrumentation.hpp"
 #include <algorithm>
 #include <functional>
+#include <memory_resource>
 
 namespace QueryStructures {
 	template <class T>
 	using BinaryFunction = std::function<T(const T&, const T&)>;
 
-	template <class T>
+	template <class T, class Statistics = Instrumentation::NoStatistics>
 	class ISparseTable {
 	protected:
 		size_t n;
 		size_t size, log;
+		size_t threads_count;
 
-		std::vector<T> a;
+		std::pmr::vector<T> a;
 		BinaryFunction<T> f;
+		[[no_unique_address]] mutable Statistics statistics;
+
+		ISparseTable(std::pmr::memory_resource* resource) : a(resource) {}
 
 		virtual void initialize() = 0;
 
-		void constructor(const std::vector<T>& v, const BinaryFunction<T>& func) {
+		void constructor(const std::vector<T>& v, const BinaryFunction<T>& func, size_t threads_count) {
 			this->n = v.size();
+			this->threads_count = threads_count;
 			this->f = func;
 			this->size = this->n;
 			this->log = NumberTheory::FloorLog::get_floor_log(this->n) + 1;
 			this->a.resize(n);
 			std::copy(v.begin(), v.end(), this->a.begin());
+			auto scope = this->statistics.start_build();
 			this->initialize();
 		}
 	public:
@@ -37,6 +46,14 @@ namespace QueryStructures {
 		}
 
 		virtual T ask_value(size_t l, size_t r) const = 0;
+
+		virtual size_t memory_bytes() const = 0;
+
+		Instrumentation::Snapshot get_statistics() const {
+			auto snapshot = this->statistics.get_snapshot();
+			snapshot.memory_bytes = this->memory_bytes();
+			return snapshot;
+		}
 	};
 
 	/// <summary>
@@ -45,30 +62,33 @@ namespace QueryStructures {
 	/// an associative, cumulative, idempotent function on a subsegment of an array.
 	/// </summary>
 	/// <typeparam name="T">The set T must have order</typeparam>
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
 	/// 
 	/// <remarks>
 	/// Asymptotics:
 	/// - Building the data structure: O(N log N), where N is the size of the input array.
 	/// - Query operation (ask): O(1) (after preprocessing).
 	/// </remarks>
-	template <class T>
-	class SparseTableWithIdempotency : public ISparseTable<T> {
+	template <class T, class Statistics = Instrumentation::NoStatistics>
+	class SparseTableWithIdempotency : public ISparseTable<T, Statistics> {
 	private:
-		std::vector<std::vector<int>> sparse;
+		std::pmr::vector<std::pmr::vector<int>> sparse;
 
 		size_t get_index(size_t i, size_t j) const {
 			return (this->f(this->a[i], this->a[j]) == this->a[i] ? i : j);
 		}
 
 		void initialize() override {
-			this->sparse.resize(this->log, std::vector<int>(this->size));
+			this->sparse.resize(this->log, std::pmr::vector<int>(this->size, this->sparse.get_allocator().resource()));
 			for (int j = 0; j < this->n; ++j) {
 				this->sparse[0][j] = j;
 			}
 			for (int level = 1; level < this->log; ++level) {
-				for (int i = 0; i + (1 << level) <= this->n; ++i) {
-					this->sparse[level][i] = get_index(this->sparse[level - 1][i], this->sparse[level - 1][i + (1 << level - 1)]);
-				}
+				Parallel::parallel_for(0, this->n - (1 << level) + 1, this->threads_count, [this, level](size_t l, size_t r) {
+					for (size_t i = l; i < r; ++i) {
+						this->sparse[level][i] = get_index(this->sparse[level - 1][i], this->sparse[level - 1][i + (1 << level - 1)]);
+					}
+				});
 			}
 		}
 	public:
@@ -77,11 +97,20 @@ namespace QueryStructures {
 		/// </summary>
 		/// <param name="v"></param>
 		/// <param name="func">function must provide the properties: associativity, commutativity, idempotency</param>
-		SparseTableWithIdempotency(const std::vector<T>& v, const BinaryFunction<T>& func) {
-			this->constructor(v, func);
+		/// <param name="threads_count">levels are built by this many threads, 0 means all hardware threads</param>
+		/// <param name="resource">memory resource for all levels of the table</param>
+		SparseTableWithIdempotency(
+			const std::vector<T>& v,
+			const BinaryFunction<T>& func,
+			size_t threads_count = 1,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			ISparseTable<T, Statistics>(resource), sparse(resource) {
+			this->constructor(v, func, threads_count);
 		}
 
 		size_t ask_index(size_t l, size_t r) const {
+			auto scope = this->statistics.start_query();
+			this->statistics.touch(2);
 			size_t len = r - l + 1;
 			size_t level = NumberTheory::FloorLog::get_floor_log(len);
 			auto left = sparse[level][l];
@@ -93,6 +122,14 @@ namespace QueryStructures {
 			auto index = this->ask_index(l, r);
 			return this->a[index];
 		}
+
+		size_t memory_bytes() const override {
+			size_t answer = sizeof(*this) + this->a.capacity() * sizeof(T) + this->sparse.capacity() * sizeof(std::pmr::vector<int>);
+			for (const auto& level : this->sparse) {
+				answer += level.capacity() * sizeof(int);
+			}
+			return answer;
+		}
 	};
 
 	/// <summary>
@@ -101,26 +138,29 @@ namespace QueryStructures {
 	/// an associative, cumulative function on a subsegment of an array.
 	/// </summary>
 	/// <typeparam name="T">The set T must have order</typeparam>
+	/// <typeparam name="Statistics">Instrumentation::NoStatistics or Instrumentation::CollectStatistics</typeparam>
 	/// 
 	/// <remarks>
 	/// Asymptotics:
 	/// - Building the data structure: O(N log N), where N is the size of the input array.
 	/// - Query operation (ask): O(1) (after preprocessing).
 	/// </remarks>
-	template <class T>
-	class SparseTable : public ISparseTable<T> {
+	template <class T, class Statistics = Instrumentation::NoStatistics>
+	class SparseTable : public ISparseTable<T, Statistics> {
 	private:
-		std::vector<std::vector<T>> sparse;
+		std::pmr::vector<std::pmr::vector<T>> sparse;
 
 		void initialize() override {
-			this->sparse.resize(this->log, std::vector<int>(this->size));
+			this->sparse.resize(this->log, std::pmr::vector<T>(this->size, this->sparse.get_allocator().resource()));
 			for (int j = 0; j < this->n; ++j) {
 				this->sparse[0][j] = this->a[j];
 			}
 			for (int level = 1; level < this->log; ++level) {
-				for (int i = 0; i + (1 << level) <= this->n; ++i) {
-					this->sparse[level][i] = this->f(this->sparse[level - 1][i], this->sparse[level - 1][i + (1 << (level - 1))]);
-				}
+				Parallel::parallel_for(0, this->n - (1 << level) + 1, this->threads_count, [this, level](size_t l, size_t r) {
+					for (size_t i = l; i < r; ++i) {
+						this->sparse[level][i] = this->f(this->sparse[level - 1][i], this->sparse[level - 1][i + (1 << (level - 1))]);
+					}
+				});
 			}
 		}
 	public:
@@ -129,20 +169,37 @@ namespace QueryStructures {
 		/// </summary>
 		/// <param name="v"></param>
 		/// <param name="func">function must provide the properties: associativity, commutativity</param>
-		SparseTable(const std::vector<T>& v, const BinaryFunction<T>& func) {
-			this->constructor(v, func);
+		/// <param name="threads_count">levels are built by this many threads, 0 means all hardware threads</param>
+		/// <param name="resource">memory resource for all levels of the table</param>
+		SparseTable(
+			const std::vector<T>& v,
+			const BinaryFunction<T>& func,
+			size_t threads_count = 1,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			ISparseTable<T, Statistics>(resource), sparse(resource) {
+			this->constructor(v, func, threads_count);
 		}
 
 		T ask_value(size_t l, size_t r) const override {
+			auto scope = this->statistics.start_query();
 			auto result = sparse[0][l];
 			++l;
 			for (int level = this->log; level >= 0; --level) {
 				if (l + (static_cast<unsigned long long>(1) << level) - 1 <= r) {
+					this->statistics.touch();
 					result = this->f(result, sparse[level][l]);
 					l += (static_cast<unsigned long long>(1) << level);
 				}
 			}
 			return result;
 		}
+
+		size_t memory_bytes() const override {
+			size_t answer = sizeof(*this) + this->a.capacity() * sizeof(T) + this->sparse.capacity() * sizeof(std::pmr::vector<T>);
+			for (const auto& level : this->sparse) {
+				answer += level.capacity() * sizeof(T);
+			}
+			return answer;
+		}
 	};
 }
@@ -0,0 +1,109 @@
+#pragma once
+#include <bit>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <memory_resource>
+#include "..//Parallel.hpp"
+
+namespace QueryStructures {
+	/// <summary>
+	/// The SparseTable2D class represents a data structure
+	/// for efficiently searching for the result of
+	/// an associative, commutative, idempotent function on a rectangle of a grid.
+	/// </summary>
+	/// <typeparam name="T"></typeparam>
+	///
+	/// <remarks>
+	/// All levels live in one row-major array: level (kr, kc) is a rows x cols grid
+	/// whose cell (i, j) holds the result on the 2^kr x 2^kc rectangle starting at (i, j).
+	/// Asymptotics:
+	/// - Building the data structure: O(R C log R log C) time and memory.
+	/// - Query operation (ask_value): O(1), four cells are combined.
+	/// </remarks>
+	template <class T>
+	class SparseTable2D {
+	private:
+		size_t rows, cols;
+		size_t row_levels, col_levels;
+		std::pmr::vector<T> table;
+		std::function<T(const T&, const T&)> f;
+
+		size_t get_index(size_t row_level, size_t col_level, size_t i, size_t j) const {
+			return ((row_level * this->col_levels + col_level) * this->rows + i) * this->cols + j;
+		}
+
+		void build_level(size_t row_level, size_t col_level, size_t threads_count) {
+			Parallel::parallel_for(0, this->rows - ((size_t)1 << row_level) + 1, threads_count, [&](size_t first_row, size_t last_row) {
+				for (size_t i = first_row; i < last_row; ++i) {
+					if (row_level == 0) {
+						size_t half = (size_t)1 << (col_level - 1);
+						const T* previous = &this->table[get_index(0, col_level - 1, i, 0)];
+						T* current = &this->table[get_index(0, col_level, i, 0)];
+						for (size_t j = 0; j + 2 * half <= this->cols; ++j) {
+							current[j] = this->f(previous[j], previous[j + half]);
+						}
+					}
+					else {
+						size_t half = (size_t)1 << (row_level - 1);
+						const T* top = &this->table[get_index(row_level - 1, col_level, i, 0)];
+						const T* bottom = &this->table[get_index(row_level - 1, col_level, i + half, 0)];
+						T* current = &this->table[get_index(row_level, col_level, i, 0)];
+						for (size_t j = 0; j + ((size_t)1 << col_level) <= this->cols; ++j) {
+							current[j] = this->f(top[j], bottom[j]);
+						}
+					}
+				}
+			}, 64);
+		}
+
+	public:
+		/// <param name="grid">rows x cols values in row-major order</param>
+		/// <param name="func">function must provide the properties: associativity, commutativity, idempotency</param>
+		/// <param name="threads_count">rows of every level are built by this many threads, 0 means all hardware threads</param>
+		/// <param name="resource">memory resource for the table</param>
+		SparseTable2D(
+			const std::vector<T>& grid,
+			size_t rows,
+			size_t cols,
+			const std::function<T(const T&, const T&)>& func,
+			size_t threads_count = 1,
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			rows(rows),
+			cols(cols),
+			row_levels(std::max<size_t>(std::bit_width(rows), 1)),
+			col_levels(std::max<size_t>(std::bit_width(cols), 1)),
+			table(resource),
+			f(func) {
+			this->table.resize(this->row_levels * this->col_levels * this->rows * this->cols);
+			std::copy(grid.begin(), grid.begin() + rows * cols, this->table.begin());
+			for (size_t row_level = 0; row_level < this->row_levels; ++row_level) {
+				for (size_t col_level = (row_level == 0); col_level < this->col_levels; ++col_level) {
+					this->build_level(row_level, col_level, threads_count);
+				}
+			}
+		}
+
+		size_t get_count_of_rows() const {
+			return this->rows;
+		}
+
+		size_t get_count_of_cols() const {
+			return this->cols;
+		}
+
+		/// <summary>
+		/// result on the rectangle [top, bottom] x [left, right]
+		/// </summary>
+		T ask_value(size_t top, size_t left, size_t bottom, size_t right) const {
+			size_t row_level = std::bit_width(bottom - top + 1) - 1;
+			size_t col_level = std::bit_width(right - left + 1) - 1;
+			size_t second_top = bottom + 1 - ((size_t)1 << row_level);
+			size_t second_left = right + 1 - ((size_t)1 << col_level);
+			return this->f(
+				this->f(this->table[get_index(row_level, col_level, top, left)], this->table[get_index(row_level, col_level, top, second_left)]),
+				this->f(this->table[get_index(row_level, col_level, second_top, left)], this->table[get_index(row_level, col_level, second_top, second_left)])
+			);
+		}
+	};
+}
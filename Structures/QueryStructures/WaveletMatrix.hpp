@@ -0,0 +1,150 @@
+#pragma once
+#include <vector>
+#include <bit>
+#include <algorithm>
+#include <type_traits>
+#include <memory_resource>
+#include "..//BitArray.hpp"
+
+namespace QueryStructures {
+	/// <summary>
+	/// The WaveletMatrix class represents a data structure
+	/// for order statistics on a subsegment of an array:
+	/// the k-th smallest value, the count of values less than x and the quantile.
+	/// </summary>
+	/// <typeparam name="T">T must be an integral type, all values must be non-negative</typeparam>
+	///
+	/// <remarks>
+	/// Every bit of the values is one level: a BitArray with a rank directory of one size_t per 32 bits,
+	/// so the structure takes about 3 bits per element per level (1 for the bit and 2 for the directory).
+	/// Asymptotics:
+	/// - Building the data structure: O(N log S), where S is the maximal value.
+	/// - Query operations: O(log S).
+	/// </remarks>
+	template <class T>
+	class WaveletMatrix {
+		static_assert(std::is_integral<T>::value, "Type T must be integral");
+
+	private:
+		class Level {
+		private:
+			BitArray bits;
+			std::pmr::vector<size_t> ones_before_container;
+			size_t count_of_zeros;
+
+		public:
+			Level(const std::vector<T>& values, size_t bit, std::pmr::memory_resource* resource) :
+				bits((int)values.size(), false, resource), ones_before_container(resource), count_of_zeros(0) {
+				for (size_t i = 0; i < values.size(); ++i) {
+					if ((values[i] >> bit) & 1) {
+						bits.set_true((int)i);
+					}
+				}
+				ones_before_container.resize(bits.get_count_of_containers() + 1);
+				for (int i = 0; i < bits.get_count_of_containers(); ++i) {
+					ones_before_container[i + 1] = ones_before_container[i] + std::popcount((unsigned int)bits.get_container(i));
+				}
+				count_of_zeros = values.size() - ones_before_container.back();
+			}
+
+			/// <summary>
+			/// count of ones in [0, index)
+			/// </summary>
+			size_t rank(size_t index) const {
+				size_t container_number = index >> main_degree;
+				unsigned int mask = (1u << (index & for_mod)) - 1;
+				size_t answer = ones_before_container[container_number];
+				if (mask != 0) {
+					answer += std::popcount((unsigned int)bits.get_container((int)container_number) & mask);
+				}
+				return answer;
+			}
+
+			size_t get_count_of_zeros() const {
+				return this->count_of_zeros;
+			}
+		};
+
+		size_t n;
+		size_t bits_count;
+		std::pmr::vector<Level> levels; // levels[0] is the highest bit
+
+	public:
+		/// <param name="resource">memory resource for the level bitmaps and their rank directories</param>
+		WaveletMatrix(std::vector<T> values, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			n(values.size()), bits_count(0), levels(resource) {
+			T maximum = values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+			this->bits_count = std::max<size_t>(std::bit_width((std::make_unsigned_t<T>)maximum), 1);
+			this->levels.reserve(this->bits_count);
+			for (size_t bit = this->bits_count; bit-- > 0;) {
+				this->levels.emplace_back(values, bit, resource);
+				std::stable_partition(values.begin(), values.end(), [bit](const T& value) {
+					return ((value >> bit) & 1) == 0;
+				});
+			}
+		}
+
+		size_t get_size() const {
+			return this->n;
+		}
+
+		/// <summary>
+		/// k-th smallest value on [l, r], k is counted from zero
+		/// </summary>
+		T kth_smallest(size_t l, size_t r, size_t k) const {
+			size_t left = l, right = r + 1;
+			T answer = 0;
+			for (size_t level = 0; level < this->bits_count; ++level) {
+				const auto& current = this->levels[level];
+				size_t ones_left = current.rank(left), ones_right = current.rank(right);
+				size_t zeros = (right - ones_right) - (left - ones_left);
+				if (k < zeros) {
+					left -= ones_left;
+					right -= ones_right;
+				}
+				else {
+					k -= zeros;
+					answer |= (T)1 << (this->bits_count - 1 - level);
+					left = current.get_count_of_zeros() + ones_left;
+					right = current.get_count_of_zeros() + ones_right;
+				}
+			}
+			return answer;
+		}
+
+		/// <summary>
+		/// count of values less than x on [l, r]
+		/// </summary>
+		size_t count_less(size_t l, size_t r, T x) const {
+			if (x <= 0) {
+				return 0;
+			}
+			if (std::bit_width((std::make_unsigned_t<T>)x) > this->bits_count) {
+				return r - l + 1;
+			}
+			size_t left = l, right = r + 1, answer = 0;
+			for (size_t level = 0; level < this->bits_count; ++level) {
+				const auto& current = this->levels[level];
+				size_t ones_left = current.rank(left), ones_right = current.rank(right);
+				if ((x >> (this->bits_count - 1 - level)) & 1) {
+					answer += (right - ones_right) - (left - ones_left);
+					left = current.get_count_of_zeros() + ones_left;
+					right = current.get_count_of_zeros() + ones_right;
+				}
+				else {
+					left -= ones_left;
+					right -= ones_right;
+				}
+			}
+			return answer;
+		}
+
+		/// <summary>
+		/// value on [l, r] that is not less than the q part of the values, q is in [0, 1]
+		/// </summary>
+		T quantile(size_t l, size_t r, double q) const {
+			q = std::clamp(q, 0.0, 1.0);
+			return this->kth_smallest(l, r, (size_t)(q * (r - l)));
+		}
+	};
+}
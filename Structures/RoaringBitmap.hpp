@@ -0,0 +1,551 @@
+#pragma once
+#include <bit>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <memory_resource>
+#include "BitArray.hpp"
+
+/// <summary>
+/// The RoaringBitmap class is a compressed set of 64-bit integers.
+/// Values are split into chunks of 2^16 by their high bits, and every non-empty chunk is stored
+/// in the smallest of three containers: a sorted array of the low 16 bits (at most 4096 values),
+/// a bitmap of 2^16 bits, or a sorted list of runs [first, last] (after run_optimize).
+/// Memory scales with the number of values instead of the largest value, unlike BitArray.
+/// </summary>
+/// <remarks>
+/// Asymptotics (C is the count of chunks):
+/// - add, contains: O(log C + log 4096).
+/// - add of increasing values: O(1) amortized.
+/// - union, intersection: O(C) container operations, each O(4096) at most.
+/// - rank: O(log C + 1024) after the first call since the last change.
+/// </remarks>
+class RoaringBitmap {
+public:
+	class Container {
+	public:
+		enum class Type {
+			array, bitmap, run
+		};
+
+		static constexpr std::size_t max_array_cardinality = 4096;
+		static constexpr std::size_t count_of_words = (1 << 16) / 64;
+
+	private:
+		using Words = std::array<std::uint64_t, count_of_words>;
+
+		Type type;
+		std::uint32_t cardinality;
+		std::pmr::vector<std::uint16_t> values; // array: sorted values, run: first and last value of every run
+		std::pmr::vector<std::uint64_t> words; // bitmap
+
+		void or_into(Words& out) const {
+			switch (this->type) {
+			case Type::array:
+				for (auto value : this->values) {
+					out[value >> 6] |= (std::uint64_t)1 << (value & 63);
+				}
+				break;
+			case Type::bitmap:
+				for (std::size_t i = 0; i < count_of_words; ++i) {
+					out[i] |= this->words[i];
+				}
+				break;
+			case Type::run:
+				for (std::size_t i = 0; i < this->values.size(); i += 2) {
+					for (std::uint32_t value = this->values[i]; value <= this->values[i + 1]; ++value) {
+						out[value >> 6] |= (std::uint64_t)1 << (value & 63);
+					}
+				}
+				break;
+			}
+		}
+
+		/// <summary>
+		/// makes an array or a bitmap container of out, whichever is smaller
+		/// </summary>
+		void assign_words(const Words& out) {
+			this->cardinality = 0;
+			for (auto word : out) {
+				this->cardinality += std::popcount(word);
+			}
+			this->values.clear();
+			this->words.clear();
+			if (this->cardinality <= max_array_cardinality) {
+				this->type = Type::array;
+				this->values.reserve(this->cardinality);
+				for (std::size_t i = 0; i < count_of_words; ++i) {
+					for (auto word = out[i]; word != 0; word &= word - 1) {
+						this->values.push_back((std::uint16_t)(i * 64 + std::countr_zero(word)));
+					}
+				}
+			}
+			else {
+				this->type = Type::bitmap;
+				this->words.assign(out.begin(), out.end());
+			}
+		}
+
+		void convert_to_bitmap() {
+			Words out{};
+			this->or_into(out);
+			this->type = Type::bitmap;
+			this->values.clear();
+			this->values.shrink_to_fit();
+			this->words.assign(out.begin(), out.end());
+		}
+
+		std::size_t get_count_of_runs() const {
+			std::size_t count = 0;
+			long long previous = -2;
+			this->for_each([&](std::uint16_t value) {
+				count += (value != previous + 1);
+				previous = value;
+			});
+			return count;
+		}
+
+	public:
+		Container(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			type(Type::array), cardinality(0), values(resource), words(resource) {}
+
+		Container(const Container& other, std::pmr::memory_resource* resource) :
+			type(other.type), cardinality(other.cardinality), values(other.values, resource), words(other.words, resource) {}
+
+		Type get_type() const {
+			return this->type;
+		}
+
+		std::size_t size() const {
+			return this->cardinality;
+		}
+
+		std::size_t memory_bytes() const {
+			return this->values.capacity() * sizeof(std::uint16_t) + this->words.capacity() * sizeof(std::uint64_t);
+		}
+
+		bool contains(std::uint16_t value) const {
+			switch (this->type) {
+			case Type::array:
+				return std::binary_search(this->values.begin(), this->values.end(), value);
+			case Type::bitmap:
+				return (this->words[value >> 6] >> (value & 63)) & 1;
+			default: {
+				auto run_end = this->get_run_after(value); // first run that starts after value
+				return run_end != 0 && value <= this->values[run_end - 1];
+			}
+			}
+		}
+
+		/// <summary>
+		/// index of the first value in values of the first run starting after value
+		/// </summary>
+		std::size_t get_run_after(std::uint16_t value) const {
+			std::size_t l = 0, r = this->values.size() / 2;
+			while (l < r) {
+				std::size_t m = (l + r) / 2;
+				if (this->values[2 * m] <= value) {
+					l = m + 1;
+				}
+				else {
+					r = m;
+				}
+			}
+			return 2 * l;
+		}
+
+		/// <summary>
+		/// extends or merges the neighbouring runs in place, a new run is inserted only if value touches none of them
+		/// </summary>
+		void add_to_runs(std::uint16_t value) {
+			std::size_t next = this->get_run_after(value);
+			bool extends_previous = next != 0 && (std::uint32_t)this->values[next - 1] + 1 >= value;
+			if (extends_previous && value <= this->values[next - 1]) {
+				return;
+			}
+			bool extends_next = next < this->values.size() && this->values[next] == value + 1;
+			if (extends_previous && extends_next) {
+				this->values[next - 1] = this->values[next + 1];
+				this->values.erase(this->values.begin() + next, this->values.begin() + next + 2);
+			}
+			else if (extends_previous) {
+				this->values[next - 1] = value;
+			}
+			else if (extends_next) {
+				this->values[next] = value;
+			}
+			else {
+				this->values.insert(this->values.begin() + next, { value, value });
+			}
+			++this->cardinality;
+			std::size_t other_bytes = std::min<std::size_t>(this->cardinality * sizeof(std::uint16_t), count_of_words * sizeof(std::uint64_t));
+			if (this->values.size() * sizeof(std::uint16_t) > other_bytes) {
+				Words out{};
+				this->or_into(out);
+				this->assign_words(out);
+			}
+		}
+
+		void add(std::uint16_t value) {
+			if (this->type == Type::run) {
+				this->add_to_runs(value);
+				return;
+			}
+			if (this->type == Type::array) {
+				auto it = std::lower_bound(this->values.begin(), this->values.end(), value);
+				if (it != this->values.end() && *it == value) {
+					return;
+				}
+				this->values.insert(it, value);
+				++this->cardinality;
+				if (this->cardinality > max_array_cardinality) {
+					this->convert_to_bitmap();
+				}
+				return;
+			}
+			auto& word = this->words[value >> 6];
+			auto bit = (std::uint64_t)1 << (value & 63);
+			this->cardinality += (word & bit) == 0;
+			word |= bit;
+		}
+
+		/// <summary>
+		/// adds all values of [first, last]
+		/// </summary>
+		void add_range(std::uint16_t first, std::uint16_t last) {
+			Words out{};
+			this->or_into(out);
+			for (std::uint32_t value = first; value <= last; ++value) {
+				out[value >> 6] |= (std::uint64_t)1 << (value & 63);
+			}
+			this->assign_words(out);
+			this->run_optimize();
+		}
+
+		/// <summary>
+		/// count of values less than or equal to value
+		/// </summary>
+		std::size_t rank(std::uint16_t value) const {
+			switch (this->type) {
+			case Type::array:
+				return std::upper_bound(this->values.begin(), this->values.end(), value) - this->values.begin();
+			case Type::bitmap: {
+				std::size_t answer = 0;
+				std::size_t word_number = value >> 6;
+				for (std::size_t i = 0; i < word_number; ++i) {
+					answer += std::popcount(this->words[i]);
+				}
+				std::uint64_t mask = (value & 63) == 63 ? ~(std::uint64_t)0 : ((std::uint64_t)1 << ((value & 63) + 1)) - 1;
+				return answer + std::popcount(this->words[word_number] & mask);
+			}
+			default: {
+				std::size_t answer = 0;
+				std::size_t run_end = this->get_run_after(value);
+				for (std::size_t i = 0; i < run_end; i += 2) {
+					answer += std::min<std::uint32_t>(this->values[i + 1], value) - this->values[i] + 1;
+				}
+				return answer;
+			}
+			}
+		}
+
+		/// <summary>
+		/// calls func(value) for every value in increasing order
+		/// </summary>
+		template <class Function>
+		void for_each(Function&& func) const {
+			switch (this->type) {
+			case Type::array:
+				for (auto value : this->values) {
+					func(value);
+				}
+				break;
+			case Type::bitmap:
+				for (std::size_t i = 0; i < count_of_words; ++i) {
+					for (auto word = this->words[i]; word != 0; word &= word - 1) {
+						func((std::uint16_t)(i * 64 + std::countr_zero(word)));
+					}
+				}
+				break;
+			case Type::run:
+				for (std::size_t i = 0; i < this->values.size(); i += 2) {
+					for (std::uint32_t value = this->values[i]; value <= this->values[i + 1]; ++value) {
+						func((std::uint16_t)value);
+					}
+				}
+				break;
+			}
+		}
+
+		/// <summary>
+		/// switches to the run container if it is smaller than the current one
+		/// </summary>
+		void run_optimize() {
+			if (this->type == Type::run) {
+				return;
+			}
+			std::size_t count_of_runs = this->get_count_of_runs();
+			std::size_t current_bytes = this->type == Type::array ? this->cardinality * sizeof(std::uint16_t) : count_of_words * sizeof(std::uint64_t);
+			if (2 * count_of_runs * sizeof(std::uint16_t) >= current_bytes) {
+				return;
+			}
+			std::pmr::vector<std::uint16_t> runs(this->values.get_allocator().resource());
+			runs.reserve(2 * count_of_runs);
+			long long previous = -2;
+			this->for_each([&](std::uint16_t value) {
+				if (value != previous + 1) {
+					runs.push_back(value);
+					runs.push_back(value);
+				}
+				runs.back() = value;
+				previous = value;
+			});
+			this->type = Type::run;
+			this->values = std::move(runs);
+			this->words.clear();
+			this->words.shrink_to_fit();
+		}
+
+		static Container unite(const Container& a, const Container& b, std::pmr::memory_resource* resource) {
+			Container answer(resource);
+			if (a.type == Type::array && b.type == Type::array && a.cardinality + b.cardinality <= max_array_cardinality) {
+				answer.values.resize(a.cardinality + b.cardinality);
+				auto end = std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(), answer.values.begin());
+				answer.values.resize(end - answer.values.begin());
+				answer.cardinality = (std::uint32_t)answer.values.size();
+				return answer;
+			}
+			Words out{};
+			a.or_into(out);
+			b.or_into(out);
+			answer.assign_words(out);
+			return answer;
+		}
+
+		static Container intersect(const Container& a, const Container& b, std::pmr::memory_resource* resource) {
+			Container answer(resource);
+			if (a.type == Type::array || b.type == Type::array) {
+				const Container& small = a.type == Type::array ? a : b;
+				const Container& other = a.type == Type::array ? b : a;
+				for (auto value : small.values) {
+					if (other.contains(value)) {
+						answer.values.push_back(value);
+					}
+				}
+				answer.cardinality = (std::uint32_t)answer.values.size();
+				return answer;
+			}
+			Words first{}, second{};
+			a.or_into(first);
+			b.or_into(second);
+			for (std::size_t i = 0; i < count_of_words; ++i) {
+				first[i] &= second[i];
+			}
+			answer.assign_words(first);
+			return answer;
+		}
+	};
+
+private:
+	std::pmr::vector<std::uint64_t> keys; // value >> 16 of the values of every container
+	std::pmr::vector<Container> containers;
+	mutable std::pmr::vector<std::uint64_t> count_before_container; // rank directory, empty if outdated
+
+	static std::uint64_t get_key(std::uint64_t value) {
+		return value >> 16;
+	}
+
+	static std::uint16_t get_low(std::uint64_t value) {
+		return (std::uint16_t)value;
+	}
+
+	std::size_t find_container(std::uint64_t key) const {
+		return std::lower_bound(this->keys.begin(), this->keys.end(), key) - this->keys.begin();
+	}
+
+	std::pmr::memory_resource* get_resource() const {
+		return this->keys.get_allocator().resource();
+	}
+
+	Container& get_or_insert_container(std::uint64_t key) {
+		std::size_t index = (!this->keys.empty() && this->keys.back() == key) ? this->keys.size() - 1 : this->find_container(key);
+		if (index == this->keys.size() || this->keys[index] != key) {
+			this->keys.insert(this->keys.begin() + index, key);
+			this->containers.insert(this->containers.begin() + index, Container(this->get_resource()));
+		}
+		this->count_before_container.clear();
+		return this->containers[index];
+	}
+
+	void push_back(std::uint64_t key, Container&& container) {
+		if (container.size() > 0) {
+			this->keys.push_back(key);
+			this->containers.push_back(std::move(container));
+		}
+	}
+
+public:
+	RoaringBitmap(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+		keys(resource), containers(resource), count_before_container(resource) {}
+
+	/// <summary>
+	/// set of the indices of the true bits of bits
+	/// </summary>
+	RoaringBitmap(const BitArray& bits, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : RoaringBitmap(resource) {
+		for (int i = 0; i < bits.get_count_of_containers(); ++i) {
+			for (auto word = (unsigned int)bits.get_container(i); word != 0; word &= word - 1) {
+				std::uint64_t value = ((std::uint64_t)i << main_degree) + std::countr_zero(word);
+				if (value < (std::uint64_t)bits.size()) {
+					this->add(value);
+				}
+			}
+		}
+	}
+
+	std::size_t size() const {
+		std::size_t answer = 0;
+		for (const auto& container : this->containers) {
+			answer += container.size();
+		}
+		return answer;
+	}
+
+	bool empty() const {
+		return this->containers.empty();
+	}
+
+	std::size_t get_count_of_containers() const {
+		return this->containers.size();
+	}
+
+	const Container& get_container(std::size_t index) const {
+		return this->containers[index];
+	}
+
+	std::size_t memory_bytes() const {
+		std::size_t answer = sizeof(*this) + this->keys.capacity() * sizeof(std::uint64_t) + this->containers.capacity() * sizeof(Container);
+		for (const auto& container : this->containers) {
+			answer += container.memory_bytes();
+		}
+		return answer;
+	}
+
+	bool contains(std::uint64_t value) const {
+		std::size_t index = this->find_container(get_key(value));
+		return index < this->keys.size() && this->keys[index] == get_key(value) && this->containers[index].contains(get_low(value));
+	}
+
+	void add(std::uint64_t value) {
+		this->get_or_insert_container(get_key(value)).add(get_low(value));
+	}
+
+	/// <summary>
+	/// adds all values of [first, last], the touched containers become runs where that is smaller
+	/// </summary>
+	void add_range(std::uint64_t first, std::uint64_t last) {
+		for (std::uint64_t key = get_key(first); key <= get_key(last); ++key) {
+			std::uint16_t low = key == get_key(first) ? get_low(first) : 0;
+			std::uint16_t high = key == get_key(last) ? get_low(last) : UINT16_MAX;
+			this->get_or_insert_container(key).add_range(low, high);
+		}
+	}
+
+	/// <summary>
+	/// converts every container to runs where that is smaller
+	/// </summary>
+	void run_optimize() {
+		for (auto& container : this->containers) {
+			container.run_optimize();
+		}
+	}
+
+	/// <summary>
+	/// count of values less than or equal to value
+	/// </summary>
+	std::size_t rank(std::uint64_t value) const {
+		if (this->count_before_container.size() != this->containers.size() + 1) {
+			this->count_before_container.assign(this->containers.size() + 1, 0);
+			for (std::size_t i = 0; i < this->containers.size(); ++i) {
+				this->count_before_container[i + 1] = this->count_before_container[i] + this->containers[i].size();
+			}
+		}
+		std::uint64_t key = get_key(value);
+		std::size_t index = this->find_container(key);
+		std::size_t answer = this->count_before_container[index];
+		if (index < this->keys.size() && this->keys[index] == key) {
+			answer += this->containers[index].rank(get_low(value));
+		}
+		return answer;
+	}
+
+	/// <summary>
+	/// calls func(value) for every value in increasing order
+	/// </summary>
+	template <class Function>
+	void for_each(Function&& func) const {
+		for (std::size_t i = 0; i < this->containers.size(); ++i) {
+			std::uint64_t high = this->keys[i] << 16;
+			this->containers[i].for_each([&](std::uint16_t low) {
+				func(high | low);
+			});
+		}
+	}
+
+	RoaringBitmap operator|(const RoaringBitmap& other) const {
+		RoaringBitmap answer(this->get_resource());
+		std::size_t i = 0, j = 0;
+		while (i < this->keys.size() || j < other.keys.size()) {
+			if (j == other.keys.size() || (i < this->keys.size() && this->keys[i] < other.keys[j])) {
+				answer.push_back(this->keys[i], Container(this->containers[i], answer.get_resource()));
+				++i;
+			}
+			else if (i == this->keys.size() || other.keys[j] < this->keys[i]) {
+				answer.push_back(other.keys[j], Container(other.containers[j], answer.get_resource()));
+				++j;
+			}
+			else {
+				answer.push_back(this->keys[i], Container::unite(this->containers[i], other.containers[j], answer.get_resource()));
+				++i;
+				++j;
+			}
+		}
+		return answer;
+	}
+
+	RoaringBitmap operator&(const RoaringBitmap& other) const {
+		RoaringBitmap answer(this->get_resource());
+		std::size_t i = 0, j = 0;
+		while (i < this->keys.size() && j < other.keys.size()) {
+			if (this->keys[i] < other.keys[j]) {
+				++i;
+			}
+			else if (other.keys[j] < this->keys[i]) {
+				++j;
+			}
+			else {
+				answer.push_back(this->keys[i], Container::intersect(this->containers[i], other.containers[j], answer.get_resource()));
+				++i;
+				++j;
+			}
+		}
+		return answer;
+	}
+
+	/// <summary>
+	/// BitArray of the given size with true bits at the values less than size
+	/// </summary>
+	BitArray to_bit_array(int size, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const {
+		BitArray answer(size, false, resource);
+		std::size_t end = this->find_container(get_key((std::uint64_t)size));
+		for (std::size_t i = 0; i <= end && i < this->containers.size(); ++i) {
+			std::uint64_t high = this->keys[i] << 16;
+			this->containers[i].for_each([&](std::uint16_t low) {
+				if ((high | low) < (std::uint64_t)size) {
+					answer.set_true((int)(high | low));
+				}
+			});
+		}
+		return answer;
+	}
+};
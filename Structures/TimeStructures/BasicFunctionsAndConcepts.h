@@ -24,7 +24,12 @@ namespace TimeStructures {
 
 	static const size_t count_of_month_in_year = 12;
 
-	static const int count_of_days_in_month[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	static constexpr int count_of_days_in_month[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+	/// <summary>
+	/// count_of_days_before_month[i] = count of days in a common year before the i-th month
+	/// </summary>
+	static constexpr int count_of_days_before_month[] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 };
 
 	static const std::string number_to_month_name[] = {
 		"January", "February", "March", "April", "May", "June",
@@ -46,26 +51,117 @@ namespace TimeStructures {
 		{"December", 11}
 	};
 
-	static inline bool is_high_year(const size_t& year_number) {
+	static constexpr inline bool is_high_year(const size_t& year_number) {
 		return year_number % 400 == 0 || (year_number % 4 == 0 && year_number % 100 != 0);
 	}
 
-	static inline size_t get_count_of_days_in_year(const size_t& year_number) {
+	static constexpr inline size_t get_count_of_days_in_year(const size_t& year_number) {
 		return (size_t)366 - !is_high_year(year_number);
 	}
 
-	static inline size_t get_count_of_days_in_month(const size_t& month_number, bool high_year = false) {
+	static constexpr inline size_t get_count_of_days_in_month(const size_t& month_number, bool high_year = false) {
 		return count_of_days_in_month[month_number] + (month_number == 1 && high_year);
 	}
 
-	static inline std::pair<size_t, size_t> get_month_and_day_number(size_t day_number_in_year, bool high_year = false) {
-		size_t sum_count_of_days = 0, month_number = 0;
-		while (sum_count_of_days <= day_number_in_year) {
-			sum_count_of_days += get_count_of_days_in_month(month_number, high_year);
+	/// <summary>
+	/// number of the day in its year, the day and the month are numbered from 0
+	/// </summary>
+	static constexpr inline size_t get_day_number_in_year(size_t month_number, size_t day_number, bool high_year = false) {
+		return count_of_days_before_month[month_number] + (month_number > 1 && high_year) + day_number;
+	}
+
+	/// <summary>
+	/// O(1): no month is longer than 32 days, so day_number_in_year / 32 is the month or the month before it
+	/// </summary>
+	static constexpr inline std::pair<size_t, size_t> get_month_and_day_number(size_t day_number_in_year, bool high_year = false) {
+		size_t month_number = day_number_in_year / 32;
+		if (month_number < count_of_month_in_year - 1 && day_number_in_year >= get_day_number_in_year(month_number + 1, 0, high_year)) {
 			++month_number;
 		}
-		--month_number;
-		sum_count_of_days -= get_count_of_days_in_month(month_number, high_year);
-		return { month_number, day_number_in_year - sum_count_of_days };
+		return { month_number, day_number_in_year - get_day_number_in_year(month_number, 0, high_year) };
+	}
+
+	/// <summary>
+	/// date of the proleptic Gregorian calendar, not earlier than January 1 of the year 0
+	/// </summary>
+	struct CivilDate {
+		size_t year_number;
+		size_t month_number; // from 0
+		size_t day_number; // from 0
+
+		constexpr bool operator==(const CivilDate& other) const = default;
+	};
+
+	/// <summary>
+	/// serial day of the date: count of days since January 1, 1970 (negative for earlier days),
+	/// the day and the month are numbered from 0
+	/// </summary>
+	/// <remarks>
+	/// The year is shifted to start in March, so the leap day is the last day of a shifted year
+	/// and the days before a shifted month are given by the linear formula (153 * m + 2) / 5.
+	/// The Gregorian calendar repeats every 400 years (146097 days).
+	/// </remarks>
+	static constexpr inline long long days_from_civil(size_t year_number, size_t month_number, size_t day_number) {
+		long long year = (long long)year_number - (month_number < 2);
+		long long era = (year >= 0 ? year : year - 399) / 400;
+		long long year_of_era = year - era * 400; // [0, 399]
+		long long shifted_month = (month_number + 10) % 12; // March is 0
+		long long day_of_year = (153 * shifted_month + 2) / 5 + day_number; // [0, 365]
+		long long day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year; // [0, 146096]
+		return era * 146097 + day_of_era - 719468;
+	}
+
+	static constexpr inline long long days_from_civil(const CivilDate& date) {
+		return days_from_civil(date.year_number, date.month_number, date.day_number);
+	}
+
+	/// <summary>
+	/// inverse of days_from_civil
+	/// </summary>
+	static constexpr inline CivilDate civil_from_days(long long serial_day) {
+		serial_day += 719468;
+		long long era = (serial_day >= 0 ? serial_day : serial_day - 146096) / 146097;
+		long long day_of_era = serial_day - era * 146097; // [0, 146096]
+		long long year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365; // [0, 399]
+		long long day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100); // [0, 365]
+		long long shifted_month = (5 * day_of_year + 2) / 153; // March is 0
+		long long day_number = day_of_year - (153 * shifted_month + 2) / 5;
+		long long month_number = (shifted_month + 2) % 12;
+		long long year = year_of_era + era * 400 + (month_number < 2);
+		return { (size_t)year, (size_t)month_number, (size_t)day_number };
+	}
+
+	/// <summary>
+	/// number of the day of the week (Monday is 0), January 1, 1970 was Thursday
+	/// </summary>
+	static constexpr inline size_t get_day_week_number(long long serial_day) {
+		long long shifted = serial_day + 3;
+		return (size_t)(shifted >= 0 ? shifted % 7 : (shifted % 7 + 7) % 7);
+	}
+
+	static constexpr inline size_t get_day_week_number(const CivilDate& date) {
+		return get_day_week_number(days_from_civil(date));
+	}
+
+	static constexpr inline size_t get_day_number_in_year(const CivilDate& date) {
+		return get_day_number_in_year(date.month_number, date.day_number, is_high_year(date.year_number));
+	}
+
+	/// <summary>
+	/// date count_of_days days after date (before it if count_of_days is negative)
+	/// </summary>
+	static constexpr inline CivilDate add_days(const CivilDate& date, long long count_of_days) {
+		return civil_from_days(days_from_civil(date) + count_of_days);
+	}
+
+	static constexpr inline CivilDate subtract_days(const CivilDate& date, long long count_of_days) {
+		return add_days(date, -count_of_days);
+	}
+
+	/// <summary>
+	/// count of days from first to second, negative if second is earlier
+	/// </summary>
+	static constexpr inline long long get_count_of_days_between(const CivilDate& first, const CivilDate& second) {
+		return days_from_civil(second) - days_from_civil(first);
 	}
 }
@@ -0,0 +1,227 @@
+#pragma once
+#include <bit>
+#include <span>
+#include <iterator>
+#include <algorithm>
+#include <memory_resource>
+#include "BasicFunctionsAndConcepts.h"
+#include "../BitArray.hpp"
+
+namespace TimeStructures {
+	/// <summary>
+	/// The CalendarStore class keeps descriptions of the days of a range of dates
+	/// without storing anything for days that were never annotated.
+	/// </summary>
+	/// <typeparam name="Description">must be default constructible and support +=</typeparam>
+	///
+	/// <remarks>
+	/// Days are indexed by serial day (see days_from_civil). A BitArray marks the annotated days,
+	/// a rank directory counts the marks before every container of the BitArray,
+	/// and descriptions of the annotated days are stored densely in the order of the days,
+	/// so the descriptions of any range of dates are one contiguous subarray.
+	/// Memory: about 3 bits per day of the range (1 for the BitArray and 2 for the rank directory, one size_t per 32 days)
+	/// plus one Description per annotated day.
+	/// Asymptotics:
+	/// - get_description, is_annotated: O(1).
+	/// - add_description to an annotated day: O(1).
+	/// - add_description to a new day: O(A + D / 32) for A annotated days and D days of the range,
+	///   so ingesting N new days one by one in arbitrary order costs O(N (A + D / 32)), use add_descriptions instead.
+	/// - add_descriptions of K entries: O(A + K log K + D / 32), one merge pass.
+	/// - get_descriptions of a range: O(1).
+	/// </remarks>
+	template <class Description>
+	class CalendarStore {
+		static_assert(std::is_default_constructible<Description>::value, "Description must be default constructible");
+
+	private:
+		long long first_day;
+		size_t count_of_days;
+		BitArray annotated;
+		std::pmr::vector<size_t> annotated_before_container;
+		std::pmr::vector<Description> descriptions;
+
+		bool contains_day(long long serial_day) const {
+			return this->first_day <= serial_day && serial_day < this->first_day + (long long)this->count_of_days;
+		}
+
+		/// <summary>
+		/// count of annotated days in [first_day, first_day + index)
+		/// </summary>
+		size_t rank(size_t index) const {
+			size_t container_number = index >> main_degree;
+			unsigned int mask = (1u << (index & for_mod)) - 1;
+			size_t answer = this->annotated_before_container[container_number];
+			if (mask != 0) {
+				answer += std::popcount((unsigned int)this->annotated.get_container((int)container_number) & mask);
+			}
+			return answer;
+		}
+
+		/// <summary>
+		/// [begin, end) of the descriptions of the days from first to last inclusive, clamped to the store
+		/// </summary>
+		std::pair<size_t, size_t> get_range(long long first, long long last) const {
+			first = std::max(first, this->first_day);
+			last = std::min(last, this->first_day + (long long)this->count_of_days - 1);
+			if (first > last) {
+				return { 0, 0 };
+			}
+			return { this->rank(first - this->first_day), this->rank(last - this->first_day + 1) };
+		}
+
+	public:
+		/// <param name="first_date">the first day of the store</param>
+		/// <param name="last_date">the last day of the store, inclusive</param>
+		/// <param name="resource">memory resource for the bitmap, the rank directory and the descriptions</param>
+		CalendarStore(const CivilDate& first_date, const CivilDate& last_date, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			first_day(days_from_civil(first_date)),
+			count_of_days(days_from_civil(last_date) - days_from_civil(first_date) + 1),
+			annotated((int)count_of_days, false, resource),
+			annotated_before_container(annotated.get_count_of_containers() + 1, resource),
+			descriptions(resource) {
+
+		}
+
+		long long get_first_day() const {
+			return this->first_day;
+		}
+
+		size_t get_count_of_days() const {
+			return this->count_of_days;
+		}
+
+		size_t get_count_of_annotated_days() const {
+			return this->descriptions.size();
+		}
+
+		bool is_annotated(long long serial_day) const {
+			return this->contains_day(serial_day) && this->annotated[(int)(serial_day - this->first_day)];
+		}
+
+		bool is_annotated(const CivilDate& date) const {
+			return this->is_annotated(days_from_civil(date));
+		}
+
+		/// <summary>
+		/// returns false if the day is out of the store
+		/// </summary>
+		bool add_description(long long serial_day, Description description) {
+			if (!this->contains_day(serial_day)) {
+				return false;
+			}
+			size_t index = serial_day - this->first_day;
+			size_t position = this->rank(index);
+			if (this->annotated[(int)index]) {
+				this->descriptions[position] += description;
+				return true;
+			}
+			this->annotated.set_true((int)index);
+			for (size_t i = (index >> main_degree) + 1; i < this->annotated_before_container.size(); ++i) {
+				++this->annotated_before_container[i];
+			}
+			this->descriptions.insert(this->descriptions.begin() + position, std::move(description));
+			return true;
+		}
+
+		bool add_description(const CivilDate& date, Description description) {
+			return this->add_description(days_from_civil(date), std::move(description));
+		}
+
+		/// <summary>
+		/// the same as add_description for every entry (serial day, description) in the order of entries, but at once:
+		/// the entries are sorted by day and merged with the annotated days in one pass,
+		/// entries out of the store are skipped, returns the count of added entries
+		/// </summary>
+		size_t add_descriptions(std::span<const std::pair<long long, Description>> entries) {
+			auto resource = this->descriptions.get_allocator().resource();
+			std::pmr::vector<size_t> order(resource);
+			order.reserve(entries.size());
+			for (size_t i = 0; i < entries.size(); ++i) {
+				if (this->contains_day(entries[i].first)) {
+					order.push_back(i);
+				}
+			}
+			std::stable_sort(order.begin(), order.end(), [&entries](size_t a, size_t b) { return entries[a].first < entries[b].first; });
+
+			std::pmr::vector<Description> merged(resource);
+			std::pmr::vector<size_t> new_indices(resource);
+			merged.reserve(this->descriptions.size() + order.size());
+			size_t old_position = 0;
+			for (size_t i = 0; i < order.size();) {
+				size_t index = entries[order[i]].first - this->first_day;
+				size_t position = this->rank(index);
+				std::move(this->descriptions.begin() + old_position, this->descriptions.begin() + position, std::back_inserter(merged));
+				old_position = position;
+				if (this->annotated[(int)index]) {
+					merged.push_back(std::move(this->descriptions[old_position++]));
+					merged.back() += entries[order[i]].second;
+				}
+				else {
+					merged.push_back(entries[order[i]].second);
+					new_indices.push_back(index);
+				}
+				for (++i; i < order.size() && entries[order[i]].first - this->first_day == (long long)index; ++i) {
+					merged.back() += entries[order[i]].second;
+				}
+			}
+			std::move(this->descriptions.begin() + old_position, this->descriptions.end(), std::back_inserter(merged));
+			this->descriptions = std::move(merged);
+
+			for (size_t index : new_indices) {
+				this->annotated.set_true((int)index);
+			}
+			for (size_t i = 0; i + 1 < this->annotated_before_container.size(); ++i) {
+				this->annotated_before_container[i + 1] = this->annotated_before_container[i] + std::popcount((unsigned int)this->annotated.get_container((int)i));
+			}
+			return order.size();
+		}
+
+		/// <summary>
+		/// Description() for a day that was never annotated
+		/// </summary>
+		Description get_description(long long serial_day) const {
+			if (!this->is_annotated(serial_day)) {
+				return Description();
+			}
+			return this->descriptions[this->rank(serial_day - this->first_day)];
+		}
+
+		Description get_description(const CivilDate& date) const {
+			return this->get_description(days_from_civil(date));
+		}
+
+		/// <summary>
+		/// descriptions of the annotated days from first to last inclusive, in the order of the days
+		/// </summary>
+		std::span<const Description> get_descriptions(long long first, long long last) const {
+			auto [begin, end] = this->get_range(first, last);
+			return { this->descriptions.data() + begin, end - begin };
+		}
+
+		std::span<const Description> get_descriptions(const CivilDate& first_date, const CivilDate& last_date) const {
+			return this->get_descriptions(days_from_civil(first_date), days_from_civil(last_date));
+		}
+
+		/// <summary>
+		/// calls func(serial_day, description) for every annotated day from first to last inclusive, in the order of the days
+		/// </summary>
+		template <class Function>
+		void for_each(long long first, long long last, Function&& func) const {
+			auto [begin, end] = this->get_range(first, last);
+			if (begin == end) {
+				return;
+			}
+			size_t index = std::max(first, this->first_day) - this->first_day;
+			int container_number = (int)(index >> main_degree);
+			unsigned int bits = (unsigned int)this->annotated.get_container(container_number) & ~((1u << (index & for_mod)) - 1);
+			for (size_t position = begin; position < end; ++position) {
+				while (bits == 0) {
+					bits = (unsigned int)this->annotated.get_container(++container_number);
+				}
+				long long serial_day = this->first_day + ((long long)container_number << main_degree) + std::countr_zero(bits);
+				bits &= bits - 1;
+				func(serial_day, this->descriptions[position]);
+			}
+		}
+	};
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <bit>
+#include <span>
+#include <array>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include "BasicFunctionsAndConcepts.h"
+#include "../Parallel.hpp"
+
+namespace TimeStructures {
+	static constexpr std::string_view month_names[] = {
+		"January", "February", "March", "April", "May", "June",
+		"July", "August", "September", "October", "November", "December"
+	};
+
+	static constexpr std::string_view day_week_names[] = {
+		"Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"
+	};
+
+	/// <summary>
+	/// Perfect hash of a fixed set of names: (name[1] * first_factor + name[2] * second_factor + name.size()) mod table_size
+	/// is different for all names, so a lookup is one hash, one table load and one comparison.
+	/// The table is built at compile time and the constructor fails to compile if the hash has collisions.
+	/// </summary>
+	template <size_t count_of_names, size_t table_size, size_t first_factor, size_t second_factor>
+	class NameHash {
+	private:
+		std::array<unsigned char, table_size> numbers; // number of the name with this hash, count_of_names for empty slots
+		std::array<std::string_view, count_of_names> names;
+
+		static constexpr size_t hash(std::string_view name) {
+			return ((unsigned char)name[1] * first_factor + (unsigned char)name[2] * second_factor + name.size()) % table_size;
+		}
+
+	public:
+		consteval NameHash(const std::string_view(&names)[count_of_names]) : numbers{}, names{} {
+			this->numbers.fill(count_of_names);
+			for (size_t i = 0; i < count_of_names; ++i) {
+				this->names[i] = names[i];
+				size_t slot = hash(names[i]);
+				if (this->numbers[slot] != count_of_names) {
+					throw "NameHash has a collision";
+				}
+				this->numbers[slot] = (unsigned char)i;
+			}
+		}
+
+		/// <summary>
+		/// number of the name, std::nullopt if name is not one of the names
+		/// </summary>
+		constexpr std::optional<size_t> find(std::string_view name) const {
+			if (name.size() < 3) {
+				return std::nullopt;
+			}
+			size_t number = this->numbers[hash(name)];
+			if (number == count_of_names || this->names[number] != name) {
+				return std::nullopt;
+			}
+			return number;
+		}
+	};
+
+	static constexpr NameHash<count_of_month_in_year, 16, 7, 6> month_name_hash(month_names);
+	static constexpr NameHash<count_of_days_in_week, 8, 3, 6> day_week_name_hash(day_week_names);
+
+	/// <summary>
+	/// the same as month_name_to_number, without a tree walk
+	/// </summary>
+	static constexpr inline std::optional<size_t> find_month_number(std::string_view name) {
+		return month_name_hash.find(name);
+	}
+
+	/// <summary>
+	/// the same as day_name_to_day_week_number, without a tree walk
+	/// </summary>
+	static constexpr inline std::optional<size_t> find_day_week_number(std::string_view name) {
+		return day_week_name_hash.find(name);
+	}
+
+	static constexpr long long invalid_serial_day = LLONG_MIN;
+
+	/// <summary>
+	/// parses an ISO-8601 calendar date "YYYY-MM-DD" at the beginning of text
+	/// (the rest of text, like a time, is ignored), std::nullopt if it is not a valid date
+	/// </summary>
+	/// <remarks>
+	/// On little-endian machines the first 8 characters are checked and converted as one 64-bit word (SWAR):
+	/// all digits are validated by two masks, and the year is combined from its digits by two multiplications.
+	/// </remarks>
+	static inline std::optional<CivilDate> parse_iso_date(std::string_view text) {
+		if (text.size() < 10 || text[4] != '-' || text[7] != '-') {
+			return std::nullopt;
+		}
+		size_t year, month, day;
+		if constexpr (std::endian::native == std::endian::little) {
+			std::uint64_t word;
+			std::memcpy(&word, text.data(), sizeof(word));
+			const std::uint64_t digits_mask = 0x00FFFF00FFFFFFFFull; // bytes 0-3, 5, 6
+			std::uint64_t digits = word & digits_mask;
+			if ((digits & 0xF0F0F0F0F0F0F0F0ull) != (0x3030303030303030ull & digits_mask) ||
+				((digits + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull & digits_mask) != (0x3030303030303030ull & digits_mask)) {
+				return std::nullopt;
+			}
+			digits &= 0x0F0F0F0F0F0F0F0Full;
+			std::uint32_t year_digits = (std::uint32_t)digits;
+			year_digits = (year_digits * 10 + (year_digits >> 8)) & 0x00FF00FF;
+			year = (year_digits * 100 + (year_digits >> 16)) & 0xFFFF;
+			month = ((digits >> 40) & 0xF) * 10 + ((digits >> 48) & 0xF);
+		}
+		else {
+			for (size_t i : { 0, 1, 2, 3, 5, 6 }) {
+				if (text[i] < '0' || text[i] > '9') {
+					return std::nullopt;
+				}
+			}
+			year = (text[0] - '0') * 1000 + (text[1] - '0') * 100 + (text[2] - '0') * 10 + (text[3] - '0');
+			month = (text[5] - '0') * 10 + (text[6] - '0');
+		}
+		if (text[8] < '0' || text[8] > '9' || text[9] < '0' || text[9] > '9') {
+			return std::nullopt;
+		}
+		day = (text[8] - '0') * 10 + (text[9] - '0');
+		if (month < 1 || month > count_of_month_in_year || day < 1 || day > get_count_of_days_in_month(month - 1, is_high_year(year))) {
+			return std::nullopt;
+		}
+		return CivilDate{ year, month - 1, day - 1 };
+	}
+
+	/// <summary>
+	/// writes date as "YYYY-MM-DD" into out, which must have room for 10 characters,
+	/// and returns the pointer past the last written character, the year must be less than 10000
+	/// </summary>
+	static inline char* format_iso_date(const CivilDate& date, char* out) {
+		static constexpr char digit_pairs[] =
+			"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+			"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
+		std::memcpy(out, digit_pairs + 2 * (date.year_number / 100), 2);
+		std::memcpy(out + 2, digit_pairs + 2 * (date.year_number % 100), 2);
+		out[4] = '-';
+		std::memcpy(out + 5, digit_pairs + 2 * (date.month_number + 1), 2);
+		out[7] = '-';
+		std::memcpy(out + 8, digit_pairs + 2 * (date.day_number + 1), 2);
+		return out + 10;
+	}
+
+	static inline char* format_iso_date(long long serial_day, char* out) {
+		return format_iso_date(civil_from_days(serial_day), out);
+	}
+
+	/// <summary>
+	/// serial_days[i] = serial day of the date at the beginning of texts[i] or invalid_serial_day,
+	/// serial_days must have texts.size() elements, returns the count of parsed dates
+	/// </summary>
+	/// <param name="threads_count">texts are split into ranges between threads, 0 means all hardware threads</param>
+	static inline size_t parse_iso_dates(std::span<const std::string_view> texts, std::span<long long> serial_days, size_t threads_count = 1) {
+		std::atomic<size_t> count_of_parsed = 0;
+		Parallel::parallel_for(0, texts.size(), threads_count, [&](size_t l, size_t r) {
+			size_t count_of_parsed_in_range = 0;
+			for (size_t i = l; i < r; ++i) {
+				auto date = parse_iso_date(texts[i]);
+				serial_days[i] = date ? days_from_civil(*date) : invalid_serial_day;
+				count_of_parsed_in_range += date.has_value();
+			}
+			count_of_parsed += count_of_parsed_in_range;
+		}, 1 << 14);
+		return count_of_parsed;
+	}
+}
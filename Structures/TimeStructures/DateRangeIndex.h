@@ -0,0 +1,118 @@
+#pragma once
+#include <functional>
+#include <memory_resource>
+#include "BasicFunctionsAndConcepts.h"
+#include "../BitArray.hpp"
+#include "../QueryStructures/SegmentTree.hpp"
+
+namespace TimeStructures {
+	/// <summary>
+	/// The DateRangeIndex class aggregates descriptions of the days of a range of dates
+	/// ("sum, min or max of descriptions from date A to date B") with a QueryStructures::SegmentTree over serial days.
+	/// </summary>
+	/// <typeparam name="Description">must support +=, a day accumulates its descriptions as Day::add_description does</typeparam>
+	///
+	/// <remarks>
+	/// Days without descriptions hold identity, so identity must be neutral for f:
+	/// Description() for a sum, the largest value for a minimum, the smallest value for a maximum.
+	/// The descriptions of the days are the values of the tree, so a day takes one Description plus the tree vertices above it,
+	/// all allocated from the memory resource.
+	/// Asymptotics:
+	/// - Building the data structure: O(D) for D days of the range.
+	/// - add_description: O(log D).
+	/// - Query operation (ask_value): O(log D).
+	/// </remarks>
+	template <class Description>
+	class DateRangeIndex {
+	private:
+		long long first_day;
+		size_t count_of_days;
+		Description identity;
+		BitArray annotated;
+		QueryStructures::SegmentTree<Description> tree; // its values are the descriptions of the days
+
+		bool contains_day(long long serial_day) const {
+			return this->first_day <= serial_day && serial_day < this->first_day + (long long)this->count_of_days;
+		}
+
+	public:
+		/// <param name="first_date">the first day of the index</param>
+		/// <param name="last_date">the last day of the index, inclusive</param>
+		/// <param name="f">associative function to aggregate descriptions of different days</param>
+		/// <param name="identity">neutral element of f, the value of days without descriptions</param>
+		/// <param name="resource">memory resource for the bitmap and the tree</param>
+		DateRangeIndex(
+			const CivilDate& first_date,
+			const CivilDate& last_date,
+			const std::function<Description(Description, Description)>& f,
+			const Description& identity = Description(),
+			std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			first_day(days_from_civil(first_date)),
+			count_of_days(days_from_civil(last_date) - days_from_civil(first_date) + 1),
+			identity(identity),
+			annotated((int)count_of_days, false, resource),
+			tree(count_of_days, identity, f, 1, resource) {
+
+		}
+
+		long long get_first_day() const {
+			return this->first_day;
+		}
+
+		size_t get_count_of_days() const {
+			return this->count_of_days;
+		}
+
+		/// <summary>
+		/// returns false if the day is out of the index
+		/// </summary>
+		bool add_description(long long serial_day, const Description& description) {
+			if (!this->contains_day(serial_day)) {
+				return false;
+			}
+			int index = (int)(serial_day - this->first_day);
+			Description value = description;
+			if (this->annotated[index]) {
+				value = this->tree.get_value(index);
+				value += description;
+			}
+			else {
+				this->annotated.set_true(index);
+			}
+			this->tree.change_value(index, value);
+			return true;
+		}
+
+		bool add_description(const CivilDate& date, const Description& description) {
+			return this->add_description(days_from_civil(date), description);
+		}
+
+		/// <summary>
+		/// identity for a day without descriptions
+		/// </summary>
+		const Description& get_description(long long serial_day) const {
+			return this->contains_day(serial_day) ? this->tree.get_value(serial_day - this->first_day) : this->identity;
+		}
+
+		const Description& get_description(const CivilDate& date) const {
+			return this->get_description(days_from_civil(date));
+		}
+
+		/// <summary>
+		/// f of the descriptions of the days from first to last inclusive, clamped to the index,
+		/// identity if no day of the index is in the range
+		/// </summary>
+		Description ask_value(long long first, long long last) {
+			first = std::max(first, this->first_day);
+			last = std::min(last, this->first_day + (long long)this->count_of_days - 1);
+			if (first > last) {
+				return this->identity;
+			}
+			return this->tree.ask_value_on(first - this->first_day, last - this->first_day);
+		}
+
+		Description ask_value(const CivilDate& first_date, const CivilDate& last_date) {
+			return this->ask_value(days_from_civil(first_date), days_from_civil(last_date));
+		}
+	};
+}
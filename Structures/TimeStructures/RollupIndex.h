@@ -0,0 +1,192 @@
+#pragma once
+#include <deque>
+#include <array>
+#include <memory_resource>
+#include "BasicFunctionsAndConcepts.h"
+
+namespace TimeStructures {
+	enum class Granularity {
+		day, week, month, year
+	};
+
+	/// <summary>
+	/// The RollupIndex class aggregates timestamped events into day, week, month and year buckets at once.
+	/// Weeks start on Monday.
+	/// </summary>
+	/// <typeparam name="Description">must be default constructible and support +=, Description() must be neutral for +=</typeparam>
+	///
+	/// <remarks>
+	/// Every granularity keeps its buckets in a deque indexed by bucket number minus the number of the first bucket,
+	/// so an event adds its description to four buckets directly, and late events before the first bucket
+	/// only prepend empty buckets. Nothing is ever re-summed.
+	/// Asymptotics:
+	/// - add_event: O(1) amortized (plus the gap to the nearest existing bucket when the range grows).
+	/// - get_bucket: O(1).
+	/// - ask_value on a range of days: O(Y + 24 + 62) for Y whole years in the range, whole years and months are read from their buckets.
+	/// </remarks>
+	template <class Description>
+	class RollupIndex {
+		static_assert(std::is_default_constructible<Description>::value, "Description must be default constructible");
+
+	private:
+		class Buckets {
+		private:
+			long long first_number;
+			std::pmr::deque<Description> values;
+
+		public:
+			Buckets(std::pmr::memory_resource* resource) : first_number(0), values(resource) {}
+
+			void add(long long number, const Description& description) {
+				if (this->values.empty()) {
+					this->first_number = number;
+				}
+				for (; number < this->first_number; --this->first_number) {
+					this->values.emplace_front();
+				}
+				while (number >= this->first_number + (long long)this->values.size()) {
+					this->values.emplace_back();
+				}
+				this->values[number - this->first_number] += description;
+			}
+
+			Description get(long long number) const {
+				if (number < this->first_number || number >= this->first_number + (long long)this->values.size()) {
+					return Description();
+				}
+				return this->values[number - this->first_number];
+			}
+
+			long long get_first_number() const {
+				return this->first_number;
+			}
+
+			size_t size() const {
+				return this->values.size();
+			}
+		};
+
+		std::array<Buckets, 4> buckets;
+		size_t count_of_events;
+
+		static long long floor_divide(long long a, long long b) {
+			return a / b - (a % b != 0 && (a < 0) != (b < 0));
+		}
+
+		const Buckets& get_buckets(Granularity granularity) const {
+			return this->buckets[(size_t)granularity];
+		}
+
+	public:
+		RollupIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+			buckets{ Buckets(resource), Buckets(resource), Buckets(resource), Buckets(resource) }, count_of_events(0) {}
+
+		/// <summary>
+		/// number of the bucket of granularity that contains the day:
+		/// the serial day, the week since the week of January 1, 1970, year * 12 + month, or the year
+		/// </summary>
+		static long long get_bucket_number(Granularity granularity, long long serial_day) {
+			switch (granularity) {
+			case Granularity::day:
+				return serial_day;
+			case Granularity::week:
+				return floor_divide(serial_day + 3, count_of_days_in_week); // January 1, 1970 was Thursday
+			case Granularity::month: {
+				auto date = civil_from_days(serial_day);
+				return (long long)date.year_number * count_of_month_in_year + date.month_number;
+			}
+			default:
+				return civil_from_days(serial_day).year_number;
+			}
+		}
+
+		/// <summary>
+		/// serial day of the first day of the bucket
+		/// </summary>
+		static long long get_first_day_of_bucket(Granularity granularity, long long bucket_number) {
+			switch (granularity) {
+			case Granularity::day:
+				return bucket_number;
+			case Granularity::week:
+				return bucket_number * count_of_days_in_week - 3;
+			case Granularity::month:
+				return days_from_civil(bucket_number / count_of_month_in_year, bucket_number % count_of_month_in_year, 0);
+			default:
+				return days_from_civil(bucket_number, 0, 0);
+			}
+		}
+
+		size_t get_count_of_events() const {
+			return this->count_of_events;
+		}
+
+		/// <summary>
+		/// events may come in any order
+		/// </summary>
+		void add_event(long long serial_day, const Description& description) {
+			auto date = civil_from_days(serial_day);
+			this->buckets[(size_t)Granularity::day].add(serial_day, description);
+			this->buckets[(size_t)Granularity::week].add(floor_divide(serial_day + 3, count_of_days_in_week), description);
+			this->buckets[(size_t)Granularity::month].add((long long)date.year_number * count_of_month_in_year + date.month_number, description);
+			this->buckets[(size_t)Granularity::year].add(date.year_number, description);
+			++this->count_of_events;
+		}
+
+		void add_event(const CivilDate& date, const Description& description) {
+			this->add_event(days_from_civil(date), description);
+		}
+
+		/// <summary>
+		/// sum of the events of the bucket of granularity that contains the day
+		/// </summary>
+		Description get_bucket(Granularity granularity, long long serial_day) const {
+			return this->get_buckets(granularity).get(get_bucket_number(granularity, serial_day));
+		}
+
+		/// <summary>
+		/// calls func(first day of the bucket, sum of its events) for every bucket of granularity
+		/// that intersects the days from first to last inclusive, in order, empty buckets included
+		/// </summary>
+		template <class Function>
+		void for_each_bucket(Granularity granularity, long long first, long long last, Function&& func) const {
+			const auto& buckets = this->get_buckets(granularity);
+			if (buckets.size() == 0 || first > last) {
+				return;
+			}
+			long long first_number = std::max(get_bucket_number(granularity, first), buckets.get_first_number());
+			long long last_number = std::min(get_bucket_number(granularity, last), buckets.get_first_number() + (long long)buckets.size() - 1);
+			for (long long number = first_number; number <= last_number; ++number) {
+				func(get_first_day_of_bucket(granularity, number), buckets.get(number));
+			}
+		}
+
+		/// <summary>
+		/// sum of the events of the days from first to last inclusive, read from the coarsest buckets that fit into the range
+		/// </summary>
+		Description ask_value(long long first, long long last) const {
+			Description answer = Description();
+			for (long long day = first; day <= last;) {
+				auto date = civil_from_days(day);
+				long long next_year = days_from_civil(date.year_number + 1, 0, 0);
+				long long next_month = date.month_number + 1 == count_of_month_in_year ? next_year : days_from_civil(date.year_number, date.month_number + 1, 0);
+				Granularity granularity = Granularity::day;
+				long long next_day = day + 1;
+				if (date.month_number == 0 && date.day_number == 0 && next_year - 1 <= last) {
+					granularity = Granularity::year;
+					next_day = next_year;
+				}
+				else if (date.day_number == 0 && next_month - 1 <= last) {
+					granularity = Granularity::month;
+					next_day = next_month;
+				}
+				answer += this->get_bucket(granularity, day);
+				day = next_day;
+			}
+			return answer;
+		}
+
+		Description ask_value(const CivilDate& first_date, const CivilDate& last_date) const {
+			return this->ask_value(days_from_civil(first_date), days_from_civil(last_date));
+		}
+	};
+}
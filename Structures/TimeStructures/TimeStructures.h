@@ -1,2 +1,6 @@
 #pragma once
 #include "Year.h"
+#include "CalendarStore.h"
+#include "DateRangeIndex.h"
+#include "DateParsing.h"
+#include "RollupIndex.h"
@@ -3,8 +3,18 @@
 #include <algorithm>
 #include <numeric>
 #include <random>
+#include <thread>
+#include <atomic>
+#include <climits>
+#include <memory_resource>
+#include <unordered_map>
+#include <map>
+#include <set>
 #include "../Structures/NumberTheory/NumberTheory.hpp"
 #include "../Structures/QueryStructures/QueryStructures.hpp"
+#include "../Structures/Geometry/Geometry.hpp"
+#include "../Structures/TimeStructures/TimeStructures.h"
+#include "../Structures/RoaringBitmap.hpp"
 
 using namespace QueryStructures;
 
@@ -172,6 +182,993 @@ TEST_F(TestFactorizer, FactorizationTest) {
 }
 
 
+TEST(ConcurrentSegmentTreeTest, SumFunctionTest) {
+	std::vector<int> v = { 1, 3, 2, 5, 4 };
+	ConcurrentSegmentTree<int> tree(v, [](int a, int b) { return a + b; });
+
+	ASSERT_EQ(tree.ask_value_on(1, 3), 10);
+	ASSERT_EQ(tree.ask_value_on(0, 4), 15);
+	tree.change_value(2, 7);
+	ASSERT_EQ(tree.ask_value_on(2, 4), 16);
+	tree.change_values({ {0, 2}, {4, 1}, {0, 6} });
+	ASSERT_EQ(tree.ask_value_on(0, 0), 6);
+	ASSERT_EQ(tree.ask_value_on(0, 4), 22);
+}
+
+
+TEST(ConcurrentSegmentTreeTest, BatchesAreAtomicForReaders) {
+	// every batch keeps v[i] + v[size - 1 - i] == 20, so every symmetric range [l, size - 1 - l] has the sum 20 * (size / 2 - l)
+	size_t size = 1000;
+	std::vector<long long> v(size, 10);
+	ConcurrentSegmentTree<long long> tree(v, [](long long a, long long b) { return a + b; });
+
+	std::atomic<bool> stop = false;
+	std::atomic<bool> consistent = true;
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 3; ++i) {
+		readers.emplace_back([&, i]() {
+			std::mt19937 reader_generator(i);
+			while (!stop) {
+				size_t l = reader_generator() % (size / 2);
+				if (tree.ask_value_on(l, size - 1 - l) != 20 * (long long)(size / 2 - l)) {
+					consistent = false;
+				}
+			}
+		});
+	}
+	std::mt19937 generator(42);
+	for (int i = 0; i < 2000; ++i) {
+		size_t position = generator() % (size / 2);
+		long long value = (long long)(generator() % 1000) - 500;
+		tree.change_values({ {position, value}, {size - 1 - position, 20 - value} });
+	}
+	stop = true;
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	ASSERT_TRUE(consistent);
+	ASSERT_EQ(tree.ask_value_on(0, size - 1), 10 * (long long)size);
+}
+
+
+TEST(ParallelBuildTest, MatchesSequentialBuild) {
+	size_t size = 100000;
+	std::mt19937 generator(7);
+	std::vector<int> v(size);
+	std::generate(v.begin(), v.end(), [&generator]() { return (int)(generator() % 1000); });
+	auto sum = [](const int& a, const int& b) { return a + b; };
+	auto min = [](const int& a, const int& b) { return std::min(a, b); };
+
+	SparseTable<int> sparse_table(v, sum, 4);
+	SparseTableWithIdempotency<int> idempotent_sparse_table(v, min, 4);
+	SegmentTree<int> segment_tree(v, sum, 4);
+	RootDecomposition<int> root_decomposition(v, sum, generic_exponentiate<int>, 4);
+	for (int _ = 0; _ < 100; ++_) {
+		size_t l = generator() % size, r = generator() % size;
+		if (l > r) {
+			std::swap(l, r);
+		}
+		int expected_sum = std::accumulate(v.begin() + l, v.begin() + r + 1, 0);
+		int expected_min = *std::min_element(v.begin() + l, v.begin() + r + 1);
+		ASSERT_EQ(sparse_table.ask_value(l, r), expected_sum);
+		ASSERT_EQ(idempotent_sparse_table.ask_value(l, r), expected_min);
+		ASSERT_EQ(segment_tree.ask_value_on(l, r), expected_sum);
+		ASSERT_EQ(root_decomposition.get_result_on(l, r).value(), expected_sum);
+	}
+}
+
+
+TEST(WaveletMatrixTest, OrderStatisticsTest) {
+	size_t size = 2000;
+	std::mt19937 generator(3);
+	std::vector<unsigned int> v(size);
+	std::generate(v.begin(), v.end(), [&generator]() { return generator() % 5000; });
+	WaveletMatrix<unsigned int> wavelet_matrix(v);
+
+	for (int _ = 0; _ < 200; ++_) {
+		size_t l = generator() % size, r = generator() % size;
+		if (l > r) {
+			std::swap(l, r);
+		}
+		std::vector<unsigned int> sorted(v.begin() + l, v.begin() + r + 1);
+		std::sort(sorted.begin(), sorted.end());
+		size_t k = generator() % sorted.size();
+		unsigned int x = generator() % 6000;
+		ASSERT_EQ(wavelet_matrix.kth_smallest(l, r, k), sorted[k]);
+		ASSERT_EQ(wavelet_matrix.count_less(l, r, x), std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin());
+		ASSERT_EQ(wavelet_matrix.quantile(l, r, 0.5), sorted[(sorted.size() - 1) / 2]);
+	}
+}
+
+
+TEST(RangeQueries2DTest, RectangleQueriesTest) {
+	size_t rows = 37, cols = 53;
+	std::mt19937 generator(11);
+	std::vector<int> grid(rows * cols);
+	std::generate(grid.begin(), grid.end(), [&generator]() { return (int)(generator() % 1000); });
+	SparseTable2D<int> sparse_table(grid, rows, cols, [](const int& a, const int& b) { return std::min(a, b); }, 2);
+	FenwickTree2D<int> fenwick_tree(grid, rows, cols);
+	auto changed_grid = grid;
+
+	for (int _ = 0; _ < 200; ++_) {
+		size_t top = generator() % rows, bottom = generator() % rows, left = generator() % cols, right = generator() % cols;
+		if (top > bottom) {
+			std::swap(top, bottom);
+		}
+		if (left > right) {
+			std::swap(left, right);
+		}
+		int value = (int)(generator() % 1000);
+		fenwick_tree.change_value(top, left, value);
+		changed_grid[top * cols + left] = value;
+		int expected_min = INT_MAX, expected_sum = 0;
+		for (size_t i = top; i <= bottom; ++i) {
+			for (size_t j = left; j <= right; ++j) {
+				expected_min = std::min(expected_min, grid[i * cols + j]);
+				expected_sum += changed_grid[i * cols + j];
+			}
+		}
+		ASSERT_EQ(sparse_table.ask_value(top, left, bottom, right), expected_min);
+		ASSERT_EQ(fenwick_tree.ask_value(top, left, bottom, right), expected_sum);
+	}
+}
+
+
+TEST(InstrumentationTest, CollectStatisticsTest) {
+	std::vector<int> v = { 1, 3, 2, 5, 4, 6, 8, 7 };
+	SegmentTree<int, Instrumentation::CollectStatistics<>> segment_tree(v, [](int a, int b) { return a + b; });
+	ASSERT_EQ(segment_tree.ask_value_on(1, 6), 28);
+	ASSERT_EQ(segment_tree.ask_value_on(0, 7), 36);
+	segment_tree.change_value(3, 0);
+
+	auto snapshot = segment_tree.get_statistics();
+	ASSERT_EQ(snapshot.builds, 1);
+	ASSERT_EQ(snapshot.queries, 2);
+	ASSERT_EQ(snapshot.updates, 1);
+	ASSERT_GT(snapshot.touched, 0);
+	ASSERT_GE(snapshot.memory_bytes, 2 * v.size() * sizeof(int));
+	ASSERT_EQ(std::accumulate(snapshot.latency_histogram.begin(), snapshot.latency_histogram.end(), (size_t)0), 3);
+
+	NumberTheory::BasicFactorizer<Instrumentation::CollectStatistics<>> factorizer;
+	factorizer.build(1000);
+	factorizer.factorize(360);
+	ASSERT_EQ(factorizer.get_statistics().queries, 1);
+	ASSERT_EQ(NumberTheory::Factorizer().get_statistics().queries, 0);
+
+	NumberTheory::BasicSegmentedWheel<Instrumentation::CollectStatistics<>> wheel(1000);
+	size_t count_of_primes = 0;
+	wheel.ListPrimes([&count_of_primes](const size_t&) { ++count_of_primes; });
+	ASSERT_EQ(count_of_primes, 168);
+	ASSERT_EQ(wheel.get_statistics().queries, 1);
+}
+
+
+TEST(MemoryResourceTest, StructuresAllocateFromGivenResource) {
+	std::vector<int> v = { 1, 3, 2, 5, 4, 6, 8, 7 };
+	auto sum = [](const int& a, const int& b) { return a + b; };
+	std::pmr::monotonic_buffer_resource arena;
+	auto default_resource = std::pmr::set_default_resource(std::pmr::null_memory_resource()); // any allocation from the default resource throws
+
+	SparseTable<int> sparse_table(v, sum, 1, &arena);
+	SegmentTree<int> segment_tree(v, sum, 1, &arena);
+	RootDecomposition<int> root_decomposition(v, sum, generic_exponentiate<int>, 1, &arena);
+	PrefixAmounts<int> prefix_amounts(v, &arena);
+	WaveletMatrix<int> wavelet_matrix(v, &arena);
+	NumberTheory::Factorizer factorizer(&arena);
+	factorizer.build(1000);
+	auto factors = factorizer.factorize(360, &arena);
+	BitArray bits = BitArray(100, true, &arena) + BitArray(30, false, &arena);
+
+	std::pmr::set_default_resource(default_resource);
+	ASSERT_EQ(sparse_table.ask_value(1, 6), 28);
+	ASSERT_EQ(segment_tree.ask_value_on(1, 6), 28);
+	ASSERT_EQ(root_decomposition.get_result_on(1, 6).value(), 28);
+	ASSERT_EQ(prefix_amounts.ask(1, 6), 28);
+	ASSERT_EQ(wavelet_matrix.kth_smallest(1, 6, 0), 2);
+	ASSERT_EQ(std::accumulate(factors.begin(), factors.end(), (size_t)1, std::multiplies<size_t>()), 360);
+	ASSERT_EQ(bits.size(), 130);
+	ASSERT_TRUE(bits[99]);
+	ASSERT_FALSE(bits[100]);
+	ASSERT_FALSE(bits[129]);
+}
+
+
+TEST(PointCloudTest, BatchKernelsTest) {
+	std::mt19937 generator(5);
+	std::uniform_real_distribution<double> distribution(-10, 10);
+	std::vector<PointVector<double>> points;
+	Geometry::PointCloud<double, 3> cloud;
+	for (int i = 0; i < 100; ++i) {
+		points.push_back(PointVector<double>({ distribution(generator), distribution(generator), distribution(generator) }));
+		cloud.push_back(points.back());
+	}
+	PointVector<double> center({ 1, 2, 3 });
+	std::vector<double> distances(cloud.size()), dot_products(cloud.size()), pairwise(cloud.size() * cloud.size());
+	cloud.distances_to({ 1, 2, 3 }, distances.data());
+	cloud.dot_products({ 1, 2, 3 }, dot_products.data());
+	cloud.pairwise_distances(cloud, pairwise.data());
+	for (size_t i = 0; i < cloud.size(); ++i) {
+		ASSERT_NEAR(distances[i], points[i].distance(center), 1e-9);
+		ASSERT_NEAR(dot_products[i], points[i].dotProduct(center), 1e-9);
+		ASSERT_NEAR(pairwise[i * cloud.size() + (i * 7) % cloud.size()], points[i].distance(points[(i * 7) % cloud.size()]), 1e-9);
+	}
+
+	cloud.translate({ -1, -2, -3 });
+	cloud.scale(2);
+	cloud.normalize();
+	std::vector<double> norms(cloud.size());
+	cloud.norms(norms.data());
+	for (size_t i = 0; i < cloud.size(); ++i) {
+		ASSERT_NEAR(norms[i], 1, 1e-9);
+		auto expected = (points[i] - center).normalize();
+		ASSERT_NEAR(cloud.get_point(i)[2], expected.z(), 1e-9);
+	}
+	ASSERT_EQ((size_t)cloud.coordinate(1) % 64, 0);
+}
+
+
+TEST(FixedPointVectorTest, ArithmeticTest) {
+	constexpr PointVector<int, 3> a(1, 2, 3), b(2, -1, 0), c(1, 1, 1);
+	constexpr PointVector<int, 3> expression = a + b * 2 - c;
+	static_assert(expression == PointVector<int, 3>(4, -1, 2));
+	static_assert(a.dotProduct(b) == 0);
+	static_assert(a.crossProduct(b) == PointVector<int, 3>(3, 6, -5));
+	static_assert(std::is_trivially_copyable_v<PointVector<int, 2>>);
+
+	PointVector<double, 2> p(3.0, 4.0), q(0.0, 0.0);
+	ASSERT_DOUBLE_EQ(p.magnitude(), 5);
+	ASSERT_DOUBLE_EQ(p.distance(q - p), 10);
+	p = -p + p * 2;
+	p += PointVector<double, 2>(1.0, 1.0);
+	ASSERT_TRUE((p == PointVector<double, 2>(4.0, 5.0)));
+	ASSERT_DOUBLE_EQ(p.normalize().magnitude(), 1);
+}
+
+
+TEST(KDTreeTest, QueriesTest) {
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> distribution(-10, 10);
+	auto random_point = [&]() {
+		return PointVector<double>({ distribution(generator), distribution(generator), distribution(generator) });
+	};
+	std::vector<PointVector<double>> points, queries;
+	for (int i = 0; i < 2000; ++i) {
+		points.push_back(random_point());
+	}
+	for (int i = 0; i < 100; ++i) {
+		queries.push_back(random_point());
+	}
+	Geometry::KDTree<double> tree(points);
+	auto batch = tree.nearest(queries, 5, 4);
+	for (size_t q = 0; q < queries.size(); ++q) {
+		std::vector<size_t> order(points.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](size_t i, size_t j) {
+			return points[i].distance(queries[q]) < points[j].distance(queries[q]);
+		});
+		order.resize(5);
+		ASSERT_EQ(tree.nearest(queries[q], 5), order);
+		ASSERT_EQ(batch[q], order);
+
+		std::vector<size_t> in_radius, in_box;
+		for (size_t i = 0; i < points.size(); ++i) {
+			if (points[i].distance(queries[q]) <= 3) {
+				in_radius.push_back(i);
+			}
+			bool inside = true;
+			for (size_t axis = 0; axis < 3; ++axis) {
+				inside = inside && queries[q][axis] - 2 <= points[i][axis] && points[i][axis] <= queries[q][axis] + 2;
+			}
+			if (inside) {
+				in_box.push_back(i);
+			}
+		}
+		auto answer = tree.in_radius(queries[q], 3);
+		std::sort(answer.begin(), answer.end());
+		ASSERT_EQ(answer, in_radius);
+		answer = tree.in_box(queries[q] - PointVector<double>({ 2, 2, 2 }), queries[q] + PointVector<double>({ 2, 2, 2 }));
+		std::sort(answer.begin(), answer.end());
+		ASSERT_EQ(answer, in_box);
+	}
+}
+
+
+TEST(PointHashMapTest, RandomOperationsTest) {
+	std::mt19937 generator(11);
+	std::uniform_int_distribution<int> distribution(-50, 50);
+	Geometry::PointHashMap<int> map;
+	Geometry::PointHashSet set;
+	std::unordered_map<MathPointVector2DOnInt, int> expected;
+	for (int i = 0; i < 20000; ++i) {
+		MathPointVector2DOnInt key(distribution(generator) * 64, distribution(generator) * 64);
+		int operation = i % 3;
+		if (operation == 0) {
+			map[key] += i;
+			expected[key] += i;
+			set.insert(key);
+		}
+		else if (operation == 1) {
+			ASSERT_EQ(map.erase(key), expected.erase(key) == 1);
+			set.erase(key);
+		}
+		else {
+			auto value = map.find(key);
+			ASSERT_EQ(value != nullptr, expected.count(key) == 1);
+			ASSERT_EQ(set.contains(key), expected.count(key) == 1);
+			if (value != nullptr) {
+				ASSERT_EQ(*value, expected[key]);
+			}
+		}
+		ASSERT_EQ(map.size(), expected.size());
+	}
+	size_t visited = 0;
+	map.for_each([&](const MathPointVector2DOnInt& key, int value) {
+		ASSERT_EQ(value, expected[key]);
+		++visited;
+	});
+	ASSERT_EQ(visited, expected.size());
+}
+
+
+TEST(UniformGridTest, NeighbourhoodTest) {
+	std::mt19937 generator(13);
+	std::uniform_int_distribution<int> distribution(-1000, 1000);
+	std::vector<MathPointVector2DOnInt> points;
+	for (int i = 0; i < 3000; ++i) {
+		points.push_back({ distribution(generator), distribution(generator) });
+	}
+	Geometry::UniformGrid grid(points, 37);
+	for (int q = 0; q < 200; ++q) {
+		MathPointVector2DOnInt center(distribution(generator), distribution(generator));
+		std::vector<size_t> expected, near;
+		for (size_t i = 0; i < points.size(); ++i) {
+			long long dx = points[i].get_x() - center.get_x(), dy = points[i].get_y() - center.get_y();
+			if (dx * dx + dy * dy <= 100 * 100) {
+				expected.push_back(i);
+			}
+		}
+		auto answer = grid.in_radius(center, 100);
+		std::sort(answer.begin(), answer.end());
+		ASSERT_EQ(answer, expected);
+
+		grid.for_each_near(center, [&](size_t index, const MathPointVector2DOnInt& point) {
+			ASSERT_EQ(points[index], point);
+			near.push_back(index);
+		});
+		for (size_t i = 0; i < points.size(); ++i) {
+			long long dx = points[i].get_x() - center.get_x(), dy = points[i].get_y() - center.get_y();
+			if (std::abs(dx) < 37 && std::abs(dy) < 37) {
+				ASSERT_NE(std::find(near.begin(), near.end(), i), near.end());
+			}
+		}
+		auto cell = grid.get_cell(center);
+		for (size_t index : grid.get_indices_in_cell(cell)) {
+			ASSERT_EQ(grid.get_cell(points[index]), cell);
+		}
+	}
+}
+
+
+TEST(IntegerGeometryTest, PredicatesTest) {
+	MathPointVector2DOnInt low(INT_MIN, INT_MIN), high(INT_MAX, INT_MAX), corner(INT_MAX, INT_MIN);
+	ASSERT_EQ(Geometry::orientation(low, corner, high), 1);
+	ASSERT_EQ(Geometry::orientation(low, high, corner), -1);
+	ASSERT_EQ(Geometry::orientation(low, high, MathPointVector2DOnInt(0, 0)), 0);
+
+	MathPointVector2DOnInt a(0, 0), b(4, 4), c(0, 4), d(4, 0), e(5, 5), f(2, 2);
+	ASSERT_TRUE(Geometry::segments_intersect(a, b, c, d));
+	ASSERT_TRUE(Geometry::segments_intersect(a, b, b, e));
+	ASSERT_TRUE(Geometry::segments_intersect(a, e, f, b));
+	ASSERT_FALSE(Geometry::segments_intersect(a, f, b, e));
+	ASSERT_FALSE(Geometry::segments_intersect(a, c, d, b));
+
+	std::vector<MathPointVector2DOnInt> square = { a, d, b, c };
+	ASSERT_TRUE(Geometry::doubled_area(square) == 32);
+	std::reverse(square.begin(), square.end());
+	ASSERT_TRUE(Geometry::doubled_area(square) == -32);
+}
+
+
+TEST(IntegerGeometryTest, ConvexHullTest) {
+	std::mt19937 generator(17);
+	for (int test = 0; test < 20; ++test) {
+		std::uniform_int_distribution<int> distribution(-100 * (test + 1), 100 * (test + 1));
+		std::vector<MathPointVector2DOnInt> points;
+		for (int i = 0; i < 20000; ++i) {
+			points.push_back({ distribution(generator), distribution(generator) });
+		}
+		auto hull = Geometry::convex_hull(points);
+		auto parallel_hull = Geometry::convex_hull(points, 4);
+		ASSERT_EQ(hull, parallel_hull);
+		for (size_t i = 0; i < hull.size(); ++i) {
+			ASSERT_EQ(Geometry::orientation(hull[i], hull[(i + 1) % hull.size()], hull[(i + 2) % hull.size()]), 1);
+		}
+
+		Geometry::ConvexPolygonIndex index(hull);
+		for (int q = 0; q < 2000; ++q) {
+			MathPointVector2DOnInt point(distribution(generator) * 11 / 10, distribution(generator) * 11 / 10);
+			bool inside = true;
+			for (size_t i = 0; i < hull.size(); ++i) {
+				inside = inside && Geometry::orientation(hull[i], hull[(i + 1) % hull.size()], point) >= 0;
+			}
+			ASSERT_EQ(index.contains(point), inside);
+		}
+		for (const auto& point : points) {
+			ASSERT_TRUE(index.contains(point));
+		}
+	}
+
+	std::vector<MathPointVector2DOnInt> collinear = { { 3, 3 }, { 1, 1 }, { 2, 2 }, { 1, 1 } };
+	std::vector<MathPointVector2DOnInt> segment = { { 1, 1 }, { 3, 3 } };
+	ASSERT_EQ(Geometry::convex_hull(collinear), segment);
+	std::vector<MathPointVector2DOnInt> same = { { 5, 5 }, { 5, 5 } };
+	ASSERT_EQ(Geometry::convex_hull(same).size(), 1);
+}
+
+
+TEST(TransformsTest, RigidTransformTest) {
+	const double pi = std::acos(-1.0);
+	std::mt19937 generator(19);
+	std::uniform_real_distribution<double> distribution(-10, 10);
+
+	std::vector<PointVector<double>> points;
+	Geometry::PointCloud<double, 2> plane;
+	for (int i = 0; i < 1000; ++i) {
+		points.push_back(PointVector<double>({ distribution(generator), distribution(generator) }));
+		plane.push_back(points.back());
+	}
+	Geometry::AffineTransform<double, 2> rotation(Geometry::Rotation2D<double>(0.7), { 1, -2 });
+	Geometry::transform(plane, rotation, 4);
+	for (size_t i = 0; i < points.size(); ++i) {
+		auto expected = points[i].getRotated(0.7);
+		auto point = plane.get_point(i);
+		ASSERT_NEAR(point[0], expected[0] + 1, 1e-9);
+		ASSERT_NEAR(point[1], expected[1] - 2, 1e-9);
+	}
+
+	auto quarter_turn = Geometry::Quaternion<double>::from_axis_angle({ 0, 0, 2 }, pi / 2);
+	auto around_x = Geometry::Quaternion<double>::from_axis_angle({ 1, 0, 0 }, pi / 2);
+	Geometry::AffineTransform<double, 3> first(quarter_turn), second(around_x), both(around_x * quarter_turn);
+	auto composed = second * Geometry::AffineTransform<double, 3>::translating({ 0, 0, 1 }) * first;
+	std::vector<PointVector<double, 3>> space = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 1.0, 2.0, 3.0 } };
+	std::vector<PointVector<double, 3>> expected = { { 0.0, 0.0, 1.0 }, { -1.0, 0.0, 0.0 }, { -2.0, -3.0, 1.0 } };
+	std::vector<PointVector<double, 3>> expected_composed = { { 0.0, -1.0, 1.0 }, { -1.0, -1.0, 0.0 }, { -2.0, -4.0, 1.0 } };
+	auto copy = space;
+	Geometry::transform(std::span(space), both);
+	Geometry::transform(std::span(copy), composed);
+	for (size_t i = 0; i < space.size(); ++i) {
+		for (size_t axis = 0; axis < 3; ++axis) {
+			ASSERT_NEAR(space[i][axis], expected[i][axis], 1e-12);
+			ASSERT_NEAR(copy[i][axis], expected_composed[i][axis], 1e-12);
+		}
+	}
+}
+
+
+TEST(DistancesTest, DistanceMatrixTest) {
+	std::mt19937 generator(23);
+	std::uniform_real_distribution<double> distribution(-10, 10);
+	Geometry::PointCloud<double, 3> rows, cols;
+	for (int i = 0; i < 37; ++i) {
+		rows.push_back({ distribution(generator), distribution(generator), distribution(generator) });
+	}
+	for (int i = 0; i < 1000; ++i) {
+		cols.push_back({ distribution(generator), distribution(generator), distribution(generator) });
+	}
+	std::vector<double> expected(rows.size() * cols.size()), squared(expected.size()), plain(expected.size());
+	rows.pairwise_distances(cols, expected.data());
+	Geometry::squared_distance_matrix(rows, cols, squared.data(), 4);
+	Geometry::distance_matrix(rows, cols, plain.data());
+	for (size_t i = 0; i < expected.size(); ++i) {
+		ASSERT_NEAR(squared[i], expected[i] * expected[i], 1e-9);
+		ASSERT_DOUBLE_EQ(plain[i], expected[i]);
+	}
+}
+
+
+TEST(DistancesTest, ClosestPairTest) {
+	std::mt19937 generator(29);
+	for (int test = 0; test < 10; ++test) {
+		std::uniform_real_distribution<double> distribution(-1000, 1000);
+		std::vector<PointVector<double, 2>> points;
+		for (int i = 0; i < 3000; ++i) {
+			points.push_back({ distribution(generator), distribution(generator) });
+		}
+		double expected = std::numeric_limits<double>::max();
+		for (size_t i = 0; i < points.size(); ++i) {
+			for (size_t j = i + 1; j < points.size(); ++j) {
+				PointVector<double, 2> difference = points[i] - points[j];
+				expected = std::min(expected, difference.squaredMagnitude());
+			}
+		}
+		auto pair = Geometry::closest_pair(std::span<const PointVector<double, 2>>(points), test % 2 == 0 ? 1 : 4);
+		ASSERT_DOUBLE_EQ(pair.squared_distance, expected);
+		PointVector<double, 2> difference = points[pair.first] - points[pair.second];
+		ASSERT_DOUBLE_EQ(difference.squaredMagnitude(), expected);
+	}
+
+	std::vector<PointVector<double, 2>> many(50000);
+	for (size_t i = 0; i < many.size(); ++i) {
+		many[i] = PointVector<double, 2>(double(i % 250) * 3, double(i / 250) * 3);
+	}
+	many[12345] = PointVector<double, 2>(many[777].x() + 0.5, many[777].y());
+	auto pair = Geometry::closest_pair(std::span<const PointVector<double, 2>>(many), 4);
+	ASSERT_EQ(pair.first, 777);
+	ASSERT_EQ(pair.second, 12345);
+}
+
+
+TEST(CivilDateTest, ConversionTest) {
+	using namespace TimeStructures;
+	static_assert(days_from_civil(1970, 0, 0) == 0);
+	static_assert(days_from_civil(2000, 2, 0) == 11017);
+	static_assert(civil_from_days(-1) == CivilDate{ 1969, 11, 30 });
+	static_assert(get_day_week_number(CivilDate{ 2024, 1, 28 }) == 3);
+	static_assert(add_days(CivilDate{ 2023, 11, 31 }, 60) == CivilDate{ 2024, 2, 0 });
+
+	long long serial_day = days_from_civil(1600, 0, 0);
+	size_t day_week_number = get_day_week_number(serial_day);
+	for (size_t year = 1600; year < 2500; ++year) {
+		bool high_year = is_high_year(year);
+		for (size_t day_number_in_year = 0; day_number_in_year < get_count_of_days_in_year(year); ++day_number_in_year) {
+			auto [month_number, day_number] = get_month_and_day_number(day_number_in_year, high_year);
+			ASSERT_LT(day_number, get_count_of_days_in_month(month_number, high_year));
+			ASSERT_EQ(get_day_number_in_year(month_number, day_number, high_year), day_number_in_year);
+			CivilDate date{ year, month_number, day_number };
+			ASSERT_EQ(days_from_civil(date), serial_day);
+			ASSERT_EQ(civil_from_days(serial_day), date);
+			ASSERT_EQ(get_day_week_number(date), day_week_number);
+			++serial_day;
+			day_week_number = (day_week_number + 1) % count_of_days_in_week;
+		}
+	}
+	ASSERT_EQ(get_count_of_days_between(CivilDate{ 1600, 0, 0 }, CivilDate{ 2500, 0, 0 }), serial_day - days_from_civil(1600, 0, 0));
+	ASSERT_EQ(subtract_days(CivilDate{ 2024, 2, 0 }, 1), (CivilDate{ 2024, 1, 28 }));
+}
+
+
+TEST(CalendarStoreTest, SparseDaysTest) {
+	using namespace TimeStructures;
+	std::mt19937 generator(31);
+	CalendarStore<long long> store(CivilDate{ 1950, 0, 0 }, CivilDate{ 2049, 11, 30 });
+	long long first_day = days_from_civil(1950, 0, 0), last_day = days_from_civil(2049, 11, 30);
+	ASSERT_EQ(store.get_count_of_days(), last_day - first_day + 1);
+	std::map<long long, long long> expected;
+	std::uniform_int_distribution<long long> day_distribution(first_day - 10, last_day + 10);
+	for (int i = 0; i < 3000; ++i) {
+		long long serial_day = day_distribution(generator);
+		bool inside = first_day <= serial_day && serial_day <= last_day;
+		ASSERT_EQ(store.add_description(civil_from_days(serial_day), i), inside);
+		if (inside) {
+			expected[serial_day] += i;
+		}
+	}
+	ASSERT_EQ(store.get_count_of_annotated_days(), expected.size());
+	for (int q = 0; q < 300; ++q) {
+		long long first = day_distribution(generator), last = day_distribution(generator);
+		if (first > last) {
+			std::swap(first, last);
+		}
+		ASSERT_EQ(store.is_annotated(first), expected.count(first) == 1);
+		ASSERT_EQ(store.get_description(first), expected.count(first) == 1 ? expected[first] : 0);
+		std::vector<std::pair<long long, long long>> range(expected.lower_bound(first), expected.upper_bound(last)), visited;
+		store.for_each(first, last, [&](long long serial_day, long long description) {
+			visited.push_back({ serial_day, description });
+		});
+		ASSERT_EQ(visited, range);
+		auto descriptions = store.get_descriptions(civil_from_days(first), civil_from_days(last));
+		ASSERT_EQ(descriptions.size(), range.size());
+		for (size_t i = 0; i < range.size(); ++i) {
+			ASSERT_EQ(descriptions[i], range[i].second);
+		}
+	}
+
+	std::vector<std::pair<long long, long long>> entries;
+	for (int i = 0; i < 5000; ++i) {
+		entries.push_back({ i % 5 == 4 ? entries[generator() % entries.size()].first : day_distribution(generator), i });
+	}
+	CalendarStore<long long> one_by_one(CivilDate{ 1950, 0, 0 }, CivilDate{ 2049, 11, 30 });
+	size_t count_of_inside = 0;
+	for (const auto& [serial_day, description] : entries) {
+		count_of_inside += one_by_one.add_description(serial_day, description);
+		if (first_day <= serial_day && serial_day <= last_day) {
+			expected[serial_day] += description;
+		}
+	}
+	ASSERT_EQ(store.add_descriptions(entries), count_of_inside);
+	ASSERT_EQ(store.get_count_of_annotated_days(), expected.size());
+	std::vector<std::pair<long long, long long>> visited;
+	store.for_each(first_day, last_day, [&](long long serial_day, long long description) {
+		visited.push_back({ serial_day, description });
+	});
+	ASSERT_EQ(visited, (std::vector<std::pair<long long, long long>>(expected.begin(), expected.end())));
+	for (const auto& [serial_day, description] : expected) {
+		ASSERT_EQ(store.get_description(serial_day), description);
+	}
+}
+
+
+TEST(DateRangeIndexTest, AggregationTest) {
+	using namespace TimeStructures;
+	std::mt19937 generator(37);
+	CivilDate first_date{ 1990, 0, 0 }, last_date{ 2029, 11, 30 };
+	long long first_day = days_from_civil(first_date), last_day = days_from_civil(last_date);
+	DateRangeIndex<long long> sums(first_date, last_date, [](long long a, long long b) { return a + b; });
+	DateRangeIndex<long long> minimums(first_date, last_date, [](long long a, long long b) { return std::min(a, b); }, LLONG_MAX);
+	std::vector<long long> days(last_day - first_day + 1, 0);
+	std::vector<bool> annotated(days.size(), false);
+	std::uniform_int_distribution<long long> day_distribution(first_day, last_day), value_distribution(-1000, 1000);
+	for (int i = 0; i < 2000; ++i) {
+		long long serial_day = day_distribution(generator), value = value_distribution(generator);
+		ASSERT_TRUE(sums.add_description(civil_from_days(serial_day), value));
+		ASSERT_TRUE(minimums.add_description(serial_day, value));
+		days[serial_day - first_day] += value;
+		annotated[serial_day - first_day] = true;
+
+		long long first = day_distribution(generator), last = day_distribution(generator);
+		if (first > last) {
+			std::swap(first, last);
+		}
+		long long sum = 0, minimum = LLONG_MAX;
+		for (long long day = first; day <= last; ++day) {
+			sum += days[day - first_day];
+			if (annotated[day - first_day]) {
+				minimum = std::min(minimum, days[day - first_day]);
+			}
+		}
+		ASSERT_EQ(sums.ask_value(civil_from_days(first), civil_from_days(last)), sum);
+		ASSERT_EQ(minimums.ask_value(first, last), minimum);
+	}
+	ASSERT_FALSE(sums.add_description(last_day + 1, 1));
+	ASSERT_EQ(sums.ask_value(last_day + 1, last_day + 100), 0);
+	for (long long day = first_day; day <= last_day; day += 97) {
+		ASSERT_EQ(sums.get_description(day), days[day - first_day]);
+	}
+
+	std::pmr::monotonic_buffer_resource arena;
+	auto default_resource = std::pmr::set_default_resource(std::pmr::null_memory_resource()); // any allocation from the default resource throws
+	DateRangeIndex<long long> arena_sums(first_date, last_date, [](long long a, long long b) { return a + b; }, 0, &arena);
+	arena_sums.add_description(first_day + 5, 3);
+	arena_sums.add_description(first_day + 5, 4);
+	std::pmr::set_default_resource(default_resource);
+	ASSERT_EQ(arena_sums.get_description(first_day + 5), 7);
+	ASSERT_EQ(arena_sums.ask_value(first_day, last_day), 7);
+}
+
+
+TEST(DateParsingTest, NamesAndIsoDatesTest) {
+	using namespace TimeStructures;
+	static_assert(find_month_number("March") == 2);
+	static_assert(!find_month_number("Marc").has_value());
+	for (size_t i = 0; i < count_of_month_in_year; ++i) {
+		ASSERT_EQ(find_month_number(number_to_month_name[i]), month_name_to_number.at(number_to_month_name[i]));
+	}
+	for (size_t i = 0; i < count_of_days_in_week; ++i) {
+		ASSERT_EQ(find_day_week_number(day_week_number_to_name[i]), day_name_to_day_week_number.at(day_week_number_to_name[i]));
+	}
+	ASSERT_FALSE(find_day_week_number("Sun").has_value());
+	ASSERT_FALSE(find_day_week_number("Mondays").has_value());
+
+	char buffer[16];
+	for (long long serial_day = days_from_civil(1899, 0, 0); serial_day < days_from_civil(2101, 0, 0); ++serial_day) {
+		char* end = format_iso_date(serial_day, buffer);
+		ASSERT_EQ(end - buffer, 10);
+		auto date = parse_iso_date(std::string_view(buffer, end - buffer));
+		ASSERT_TRUE(date.has_value());
+		ASSERT_EQ(days_from_civil(*date), serial_day);
+	}
+	ASSERT_EQ(std::string(buffer, format_iso_date(CivilDate{ 2024, 1, 28 }, buffer)), "2024-02-29");
+
+	std::vector<std::string_view> texts = { "2023-02-29", "2024-02-29T12:00:00Z", "2024-13-01", "2024-00-10", "20x4-01-01", "2024/01/01", "2024-01-1", "0001-01-01", "9999-12-31" };
+	std::vector<long long> serial_days(texts.size());
+	ASSERT_EQ(parse_iso_dates(texts, serial_days, 2), 3);
+	std::vector<long long> expected = { invalid_serial_day, days_from_civil(2024, 1, 28), invalid_serial_day, invalid_serial_day, invalid_serial_day,
+		invalid_serial_day, invalid_serial_day, days_from_civil(1, 0, 0), days_from_civil(9999, 11, 30) };
+	ASSERT_EQ(serial_days, expected);
+}
+
+
+TEST(RollupIndexTest, GranularitiesTest) {
+	using namespace TimeStructures;
+	std::mt19937 generator(41);
+	long long first_day = days_from_civil(1995, 0, 0), last_day = days_from_civil(2004, 11, 30);
+	std::uniform_int_distribution<long long> day_distribution(first_day, last_day), value_distribution(1, 100);
+	RollupIndex<long long> index;
+	std::map<long long, long long> events;
+	for (int i = 0; i < 5000; ++i) {
+		long long serial_day = day_distribution(generator), value = value_distribution(generator);
+		index.add_event(serial_day, value);
+		events[serial_day] += value;
+	}
+	ASSERT_EQ(index.get_count_of_events(), 5000);
+	auto brute_force = [&](long long first, long long last) {
+		long long sum = 0;
+		for (auto it = events.lower_bound(first); it != events.end() && it->first <= last; ++it) {
+			sum += it->second;
+		}
+		return sum;
+	};
+	for (int q = 0; q < 500; ++q) {
+		long long day = day_distribution(generator);
+		auto date = civil_from_days(day);
+		long long week_start = day - (long long)get_day_week_number(day);
+		ASSERT_EQ(get_day_week_number(RollupIndex<long long>::get_first_day_of_bucket(Granularity::week, RollupIndex<long long>::get_bucket_number(Granularity::week, day))), 0);
+		ASSERT_EQ(index.get_bucket(Granularity::day, day), brute_force(day, day));
+		ASSERT_EQ(index.get_bucket(Granularity::week, day), brute_force(week_start, week_start + 6));
+		ASSERT_EQ(index.get_bucket(Granularity::month, day), brute_force(day - (long long)date.day_number, days_from_civil(date.year_number, date.month_number, get_count_of_days_in_month(date.month_number, is_high_year(date.year_number)) - 1)));
+		ASSERT_EQ(index.get_bucket(Granularity::year, day), brute_force(days_from_civil(date.year_number, 0, 0), days_from_civil(date.year_number, 11, 30)));
+
+		long long first = day_distribution(generator) - 400, last = day_distribution(generator) + 400;
+		if (first > last) {
+			std::swap(first, last);
+		}
+		ASSERT_EQ(index.ask_value(first, last), brute_force(first, last));
+	}
+	long long total = 0;
+	size_t count_of_months = 0;
+	index.for_each_bucket(Granularity::month, first_day - 100, last_day + 100, [&](long long bucket_first_day, long long value) {
+		ASSERT_EQ(civil_from_days(bucket_first_day).day_number, 0);
+		total += value;
+		++count_of_months;
+	});
+	ASSERT_EQ(count_of_months, 120);
+	ASSERT_EQ(total, brute_force(first_day, last_day));
+}
+
+
+TEST(RoaringBitmapTest, SetOperationsTest) {
+	std::mt19937_64 generator(43);
+	auto make = [&](RoaringBitmap& bitmap, std::set<std::uint64_t>& expected, int salt) {
+		std::uniform_int_distribution<std::uint64_t> sparse(0, (std::uint64_t)1 << 40), dense(0, 5 * 65536);
+		for (int i = 0; i < 3000; ++i) {
+			std::uint64_t value = sparse(generator);
+			bitmap.add(value);
+			expected.insert(value);
+		}
+		for (int i = 0; i < 60000; ++i) {
+			std::uint64_t value = dense(generator);
+			bitmap.add(value);
+			expected.insert(value);
+		}
+		std::uint64_t first = 1000000000000ull + salt * 50000, last = first + 200000;
+		bitmap.add_range(first, last);
+		for (std::uint64_t value = first; value <= last; ++value) {
+			expected.insert(value);
+		}
+	};
+	RoaringBitmap a, b;
+	std::set<std::uint64_t> expected_a, expected_b;
+	make(a, expected_a, 0);
+	make(b, expected_b, 1);
+	a.run_optimize();
+	ASSERT_EQ(a.size(), expected_a.size());
+
+	std::vector<std::uint64_t> values, expected_values(expected_a.begin(), expected_a.end());
+	a.for_each([&](std::uint64_t value) {
+		values.push_back(value);
+	});
+	ASSERT_EQ(values, expected_values);
+
+	std::set<std::uint64_t> expected_union = expected_a, expected_intersection;
+	expected_union.insert(expected_b.begin(), expected_b.end());
+	std::set_intersection(expected_a.begin(), expected_a.end(), expected_b.begin(), expected_b.end(), std::inserter(expected_intersection, expected_intersection.end()));
+	auto united = a | b, intersected = a & b;
+	ASSERT_EQ(united.size(), expected_union.size());
+	ASSERT_EQ(intersected.size(), expected_intersection.size());
+	values.clear();
+	intersected.for_each([&](std::uint64_t value) {
+		values.push_back(value);
+	});
+	ASSERT_EQ(values, std::vector<std::uint64_t>(expected_intersection.begin(), expected_intersection.end()));
+
+	std::uniform_int_distribution<std::uint64_t> queries(0, 1000000400000ull);
+	for (int q = 0; q < 3000; ++q) {
+		std::uint64_t value = q % 2 == 0 ? queries(generator) : queries(generator) % (6 * 65536);
+		ASSERT_EQ(united.contains(value), expected_union.count(value) == 1);
+		ASSERT_EQ(a.rank(value), (size_t)(std::upper_bound(expected_values.begin(), expected_values.end(), value) - expected_values.begin()));
+	}
+	ASSERT_LT(a.memory_bytes(), expected_a.size() * sizeof(std::uint64_t));
+
+	BitArray bits(1000000);
+	for (int i = 0; i < 1000000; i += 7) {
+		bits.set_true(i);
+	}
+	RoaringBitmap from_bits(bits);
+	ASSERT_EQ(from_bits.size(), (1000000 + 6) / 7);
+	ASSERT_EQ(from_bits.rank(999999), from_bits.size());
+	BitArray back = (from_bits & a).to_bit_array(1000000);
+	for (int i = 0; i < 1000000; ++i) {
+		ASSERT_EQ(back[i], i % 7 == 0 && expected_a.count(i) == 1);
+	}
+}
+
+
+TEST(RoaringBitmapTest, AddToRunsTest) {
+	RoaringBitmap bitmap;
+	bitmap.add_range(100, 60000);
+	size_t memory = bitmap.memory_bytes();
+	std::set<std::uint64_t> expected;
+	for (std::uint64_t value = 100; value <= 60000; ++value) {
+		expected.insert(value);
+	}
+	for (std::uint64_t value : { 60001, 99, 60003, 60002, 5, 7, 6, 100, 65535, 0 }) {
+		bitmap.add(value);
+		expected.insert(value);
+	}
+	ASSERT_LT(bitmap.memory_bytes(), memory + 1024);
+	ASSERT_EQ(bitmap.size(), expected.size());
+	std::vector<std::uint64_t> values;
+	bitmap.for_each([&](std::uint64_t value) {
+		values.push_back(value);
+	});
+	ASSERT_EQ(values, std::vector<std::uint64_t>(expected.begin(), expected.end()));
+}
+
+
+TEST(MappedEratosthenesSieveTest, MatchesEratosthenesSieveTest) {
+	const size_t n = 1000003;
+	const std::string path = "mapped_sieve_test.bin";
+	NumberTheory::EratosthenesSieve sieve(n);
+	sieve.build();
+	{
+		NumberTheory::MappedEratosthenesSieve mapped(path, n, 4, 1 << 16);
+		ASSERT_EQ(mapped.get_length(), n);
+		for (size_t i = 0; i < n; ++i) {
+			ASSERT_EQ(mapped.is_prime(i), sieve.is_prime(i));
+		}
+		mapped.flush();
+	}
+	auto reopened = NumberTheory::MappedEratosthenesSieve::open(path);
+	ASSERT_EQ(reopened.get_length(), n);
+	std::vector<size_t> primes;
+	reopened.go_through_prime_numbers([&](const size_t& p) { primes.push_back(p); });
+	ASSERT_EQ(primes, sieve.get_prime_numbers());
+	ASSERT_EQ(reopened.count_primes(0, n), primes.size());
+	ASSERT_EQ(reopened.count_primes(100, 1000), (size_t)(std::upper_bound(primes.begin(), primes.end(), 999) - std::lower_bound(primes.begin(), primes.end(), 100)));
+	ASSERT_EQ(truncate(path.c_str(), 4096), 0);
+	ASSERT_THROW(NumberTheory::MappedEratosthenesSieve::open(path), std::system_error);
+	std::remove(path.c_str());
+	ASSERT_THROW(NumberTheory::MappedEratosthenesSieve::open(path), std::system_error);
+}
+
+
+TEST(WheelPrimeTableTest, MatchesEratosthenesSieveTest) {
+	for (size_t n : { 2, 3, 6, 8, 29, 30, 31, 1000, 1000003 }) {
+		NumberTheory::EratosthenesSieve sieve(n);
+		sieve.build();
+		NumberTheory::WheelPrimeTable table(n);
+		ASSERT_EQ(table.get_length(), n);
+		std::vector<size_t> primes;
+		table.go_through_prime_numbers([&primes](const size_t& p) { primes.push_back(p); });
+		ASSERT_EQ(primes, sieve.get_prime_numbers());
+		ASSERT_EQ(table.get_count_of_primes(), primes.size());
+		for (size_t i = 0; i < n; ++i) {
+			ASSERT_EQ(table.is_prime(i), sieve.is_prime(i));
+			auto next = std::upper_bound(primes.begin(), primes.end(), i);
+			ASSERT_EQ(table.next_prime(i), next == primes.end() ? 0 : *next);
+			auto prev = std::lower_bound(primes.begin(), primes.end(), i);
+			ASSERT_EQ(table.prev_prime(i), prev == primes.begin() ? 0 : *(prev - 1));
+		}
+	}
+	NumberTheory::WheelPrimeTable table(1000000);
+	ASSERT_LT(table.memory_bytes(), 1000000 / 30 + 1000);
+}
+
+
+TEST(PrimeGapAnalyticsTest, MatchesSieveTest) {
+	for (size_t n : { 2, 3, 8, 100, 30000000 }) {
+		NumberTheory::EratosthenesSieve sieve(n);
+		sieve.build();
+		auto primes = sieve.get_prime_numbers();
+		std::vector<size_t> gap_histogram;
+		std::vector<std::pair<size_t, size_t>> maximal_gaps;
+		size_t counts[4] = { 0, 0, 0, 0 };
+		for (size_t i = 1; i < primes.size(); ++i) {
+			size_t gap = primes[i] - primes[i - 1];
+			if (gap_histogram.size() <= gap) {
+				gap_histogram.resize(gap + 1);
+			}
+			++gap_histogram[gap];
+			if (maximal_gaps.empty() || gap > maximal_gaps.back().second) {
+				maximal_gaps.emplace_back(primes[i - 1], gap);
+			}
+			counts[0] += gap == 2;
+			counts[1] += gap == 4;
+			if (i >= 2) {
+				size_t previous_gap = primes[i - 1] - primes[i - 2];
+				counts[2] += (previous_gap == 2 && gap == 4) || (previous_gap == 4 && gap == 2);
+				counts[3] += i >= 3 && primes[i - 2] - primes[i - 3] == 2 && previous_gap == 4 && gap == 2;
+			}
+		}
+		for (size_t threads_count : { 1, 4 }) {
+			NumberTheory::PrimeGapAnalytics analytics(n, threads_count);
+			ASSERT_EQ(analytics.get_count_of_primes(), primes.size());
+			ASSERT_TRUE(std::equal(gap_histogram.begin(), gap_histogram.end(), analytics.get_gap_histogram().begin(), analytics.get_gap_histogram().end()));
+			ASSERT_TRUE(std::equal(maximal_gaps.begin(), maximal_gaps.end(), analytics.get_maximal_gaps().begin(), analytics.get_maximal_gaps().end()));
+			ASSERT_EQ(analytics.get_count(NumberTheory::Constellation::twin), counts[0]);
+			ASSERT_EQ(analytics.get_count(NumberTheory::Constellation::cousin), counts[1]);
+			ASSERT_EQ(analytics.get_count(NumberTheory::Constellation::triplet), counts[2]);
+			ASSERT_EQ(analytics.get_count(NumberTheory::Constellation::quadruplet), counts[3]);
+		}
+	}
+}
+
+
+TEST(GoldbachVerifierTest, BatchTest) {
+	const size_t max_n = 20000;
+	NumberTheory::GoldbachVerifier verifier(max_n);
+	NumberTheory::EratosthenesSieve sieve(max_n + 1);
+	sieve.build();
+	ASSERT_EQ(verifier.find_counterexample(0, max_n, 4), 0);
+	auto expansions = verifier.get_expansions(1, max_n, 4);
+	auto counts = verifier.count_expansions(1, max_n, 4);
+	ASSERT_EQ(expansions.size(), max_n / 2 - 1);
+	ASSERT_EQ(counts.size(), max_n / 2 - 1);
+	for (size_t n = 4; n <= max_n; n += 2) {
+		ASSERT_EQ(expansions[n / 2 - 2], NumberTheory::get_Goldbach_expansion(n));
+		size_t count = 0;
+		for (size_t p = 2; 2 * p <= n; ++p) {
+			count += sieve.is_prime(p) && sieve.is_prime(n - p);
+		}
+		ASSERT_EQ(counts[n / 2 - 2], count);
+	}
+	ASSERT_EQ(verifier.count_expansions(9), 1); // 2 + 7
+	ASSERT_EQ(verifier.count_expansions(11), 0);
+	ASSERT_EQ(verifier.get_expansion(max_n + 2), (std::pair<size_t, size_t>(0, 0)));
+	ASSERT_EQ(verifier.get_expansions(10, 14).size(), 3);
+}
+
+
+TEST(PrimeOracleTest, MatchesSieveTest) {
+	const size_t n = 300000;
+	NumberTheory::EratosthenesSieve sieve(n + 1000);
+	sieve.build();
+	auto primes = sieve.get_prime_numbers();
+	for (size_t cache_limit : { 1000, 1 << 30 }) {
+		NumberTheory::PrimeOracle oracle(cache_limit);
+		for (size_t i = n; i-- > 0;) {
+			ASSERT_EQ(oracle.is_prime(i), sieve.is_prime(i));
+			ASSERT_EQ(oracle.next_prime(i), *std::upper_bound(primes.begin(), primes.end(), i));
+			auto prev = std::lower_bound(primes.begin(), primes.end(), i);
+			ASSERT_EQ(oracle.prev_prime(i), prev == primes.begin() ? 0 : *(prev - 1));
+		}
+		auto first = std::lower_bound(primes.begin(), primes.end(), 500), last = std::lower_bound(primes.begin(), primes.end(), 250000);
+		ASSERT_EQ(oracle.primes_in(500, 250000), std::vector<size_t>(first, last));
+	}
+	NumberTheory::PrimeOracle oracle;
+	ASSERT_TRUE(oracle.is_prime(((size_t)1 << 61) - 1));
+	ASSERT_EQ(oracle.prev_prime((size_t)1 << 61), ((size_t)1 << 61) - 1);
+	ASSERT_EQ(oracle.next_prime(18446744073709551556ull), 18446744073709551557ull);
+	ASSERT_EQ(oracle.next_prime(18446744073709551557ull), 0);
+	ASSERT_EQ(oracle.next_prime(SIZE_MAX), 0);
+	ASSERT_FALSE(oracle.is_prime(3215031751ull)); // strong pseudoprime to the bases 2, 3, 5 and 7
+	ASSERT_LE(oracle.get_cached_length(), (size_t)1 << 30);
+}
+
+TEST(PrimeOracleTest, GoldbachAndBertrandTest) {
+	NumberTheory::EratosthenesSieve sieve(20001);
+	sieve.build();
+	for (size_t n = 0; n <= 10000; ++n) {
+		std::pair<size_t, size_t> expansion = { 0, 0 };
+		for (size_t i = 2; i <= n; ++i) {
+			if (sieve.is_prime(i) && sieve.is_prime(n - i)) {
+				expansion = { i, n - i };
+				break;
+			}
+		}
+		ASSERT_EQ(NumberTheory::get_Goldbach_expansion(n), expansion);
+		std::vector<size_t> primes;
+		for (size_t j = n + 1; j < 2 * n; ++j) {
+			if (sieve.is_prime(j)) {
+				primes.push_back(j);
+			}
+		}
+		ASSERT_EQ(NumberTheory::make_sure_that_Bertrand_postulate_is_correct(n, true), primes);
+		ASSERT_EQ(NumberTheory::make_sure_that_Bertrand_postulate_is_correct(n), primes.empty() ? primes : std::vector<size_t>(1, primes[0]));
+	}
+}
+
+
 int main(int argc, char** argv) {
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();